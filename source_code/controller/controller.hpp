@@ -31,22 +31,22 @@ class Controller {
       return {0, 0};
     }
   }
-  S21Matrix StartConfusionTest(const std::string &testfile,
-                                 const double &sample_percentage) {
+  S21Matrix<double> StartConfusionTest(const std::string &testfile,
+                                       const double &sample_percentage) {
     try {
       return network_->StartConfusionTest(testfile, sample_percentage);
     } catch (const std::exception &e) {
-      S21Matrix A{0, 0};
+      S21Matrix<double> A{0, 0};
       return A;
     }
   }
-  double CalcAccuracy(const S21Matrix &conf_mx) {
+  double CalcAccuracy(const S21Matrix<double> &conf_mx) {
     return network_->CalcAccuracy(conf_mx);
   }
-  double CalcPrecision(const S21Matrix &conf_mx) {
+  double CalcPrecision(const S21Matrix<double> &conf_mx) {
     return network_->CalcPrecision(conf_mx);
   }
-  double CalcRecall(const S21Matrix &conf_mx) {
+  double CalcRecall(const S21Matrix<double> &conf_mx) {
     return network_->CalcRecall(conf_mx);
   }
   double CalcFMeasure(double prec, double recall) {
@@ -55,9 +55,12 @@ class Controller {
   std::vector<double> StartLearnNetwork(const std::string &train_file,
                                           const int &sum_epoch,
                                           const bool &continue_learn,
-                                          const std::string &test_file) {
+                                          const std::string &test_file,
+                                          const size_t &batch_size = 1,
+                                          const LearningSchedule &schedule =
+                                              LearningSchedule()) {
     return network_->StartLearnNetwork(train_file, sum_epoch, continue_learn,
-                                       test_file);
+                                       test_file, batch_size, schedule);
   }
   std::vector<double> StartCVLearn(const std::string &train_file,
                                      const unsigned coef,
@@ -67,9 +70,13 @@ class Controller {
   size_t get_result_network(const std::vector<unsigned> &input_layer) {
     return network_->PredictionNetwork(input_layer);
   }
-  void SwitchNetwork(const int &index_network, const bool &type_network) {
+  void SwitchNetwork(const int &index_network, const int &type_network) {
     network_->ChangeCurrentNetwork(index_network, type_network);
   }
+  void SetLearnThreads(const unsigned &threads) {
+    network_->SetLearnThreads(threads);
+  }
+  LearnSpeed get_learn_speed() const { return network_->get_learn_speed(); }
 
  private:
   Network *network_;  //  сеть
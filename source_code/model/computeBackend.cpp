@@ -0,0 +1,427 @@
+#include "computeBackend.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#ifdef S21_WITH_CBLAS
+#include <cblas.h>
+#endif
+
+namespace s21_kernels {
+
+namespace {
+
+/*---выбранный бэкенд свой у каждого потока---*/
+thread_local BackendType active_backend = BackendType::kSimd;
+
+/*––––––––––– reference: straightforward loops ––––––––––––––––––––––––––––*/
+
+template <class T>
+class ReferenceBackend : public ComputeBackend<T> {
+ public:
+  BackendType get_type() const override { return BackendType::kReference; }
+
+  void Gemv(const T *x, const T *w, int k, int n, int stride, T *y,
+            const T *bias) const override {
+    for (int j = 0; j < n; ++j) y[j] = bias ? bias[j] : 0;
+    for (int r = 0; r < k; ++r) {
+      const T *line = w + (size_t)r * stride;
+      for (int j = 0; j < n; ++j) y[j] += x[r] * line[j];
+    }
+  }
+
+  void GemvSparse(const T *values, const int *index, int nnz, const T *w,
+                  int n, int stride, T *y, const T *bias) const override {
+    for (int j = 0; j < n; ++j) y[j] = bias ? bias[j] : 0;
+    for (int r = 0; r < nnz; ++r) {
+      const T *line = w + (size_t)index[r] * stride;
+      for (int j = 0; j < n; ++j) y[j] += values[r] * line[j];
+    }
+  }
+
+  void GemvTransposed(const T *x, const T *w, int k, int n, int stride,
+                      T *y) const override {
+    for (int j = 0; j < n; ++j) {
+      const T *line = w + (size_t)j * stride;
+      T sum = 0;
+      for (int i = 0; i < k; ++i) sum += x[i] * line[i];
+      y[j] = sum;
+    }
+  }
+
+  void Gemm(int m, int n, int k, T alpha, const Operand<T> &a,
+            const Operand<T> &b, T beta, T *c, int ldc) const override {
+    for (int i = 0; i < m; ++i) {
+      for (int j = 0; j < n; ++j) {
+        T sum = 0;
+        for (int p = 0; p < k; ++p) {
+          sum += a.data[(size_t)i * a.row_stride + (size_t)p * a.col_stride] *
+                 b.data[(size_t)p * b.row_stride + (size_t)j * b.col_stride];
+        }
+        T &dst = c[(size_t)i * ldc + j];
+        dst = beta == 0 ? alpha * sum : alpha * sum + beta * dst;
+      }
+    }
+  }
+
+  void Ger(int m, int n, T alpha, const T *x, const T *y, T *a,
+           int lda) const override {
+    for (int i = 0; i < m; ++i) {
+      if (x[i] == 0) continue;
+      T *line = a + (size_t)i * lda;
+      for (int j = 0; j < n; ++j) line[j] += alpha * x[i] * y[j];
+    }
+  }
+
+  /*---эталон всегда считает через std::exp, режим не учитывается---*/
+  void Sigmoid(T *data, int n, const SigmoidMode &) const override {
+    for (int i = 0; i < n; ++i) data[i] = 1 / (1 + std::exp(-data[i]));
+  }
+
+  void Softmax(T *data, int n, const SigmoidMode &) const override {
+    if (n < 1) return;
+    T max = *std::max_element(data, data + n);
+    T sum = 0;
+    for (int i = 0; i < n; ++i) {
+      data[i] = std::exp(data[i] - max);
+      sum += data[i];
+    }
+    for (int i = 0; i < n; ++i) data[i] /= sum;
+  }
+
+  void Activate(T *data, int n, const Activation &activation,
+                const SigmoidMode &mode) const override {
+    T slope = activation == Activation::kLeakyRelu ? T(kLeakyReluSlope) : 0;
+    switch (activation) {
+      case Activation::kRelu:
+      case Activation::kLeakyRelu:
+        for (int i = 0; i < n; ++i) {
+          data[i] = std::max(data[i], slope * data[i]);
+        }
+        break;
+      case Activation::kTanh:
+        for (int i = 0; i < n; ++i) data[i] = std::tanh(data[i]);
+        break;
+      default:
+        Sigmoid(data, n, mode);
+    }
+  }
+
+  void ActivationDerivative(const T *output, T *delta, int n,
+                            const Activation &activation) const override {
+    for (int i = 0; i < n; ++i) {
+      T y = output[i];
+      switch (activation) {
+        case Activation::kRelu:
+          delta[i] *= y > 0 ? 1 : 0;
+          break;
+        case Activation::kLeakyRelu:
+          delta[i] *= y > 0 ? 1 : T(kLeakyReluSlope);
+          break;
+        case Activation::kTanh:
+          delta[i] *= 1 - y * y;
+          break;
+        default:
+          delta[i] *= y * (1 - y);
+      }
+    }
+  }
+
+  void MomentumStep(T *w, const T *d, T *v, int n, T lr, T mu,
+                    bool nesterov) const override {
+    for (int i = 0; i < n; ++i) {
+      v[i] = mu * v[i] + d[i];
+      w[i] += lr * (nesterov ? d[i] + mu * v[i] : v[i]);
+    }
+  }
+
+  void AdamStep(T *w, const T *d, T *m, T *s, int n, T step, T beta1,
+                T beta2, T epsilon) const override {
+    for (int i = 0; i < n; ++i) {
+      m[i] = beta1 * m[i] + (1 - beta1) * d[i];
+      s[i] = beta2 * s[i] + (1 - beta2) * d[i] * d[i];
+      w[i] += step * m[i] / (std::sqrt(s[i]) + epsilon);
+    }
+  }
+};
+
+/*––––––––––– simd: the kernels of matrixKernels.cpp –––––––––––––––––––––––*/
+
+template <class T>
+class SimdBackend : public ComputeBackend<T> {
+ public:
+  BackendType get_type() const override { return BackendType::kSimd; }
+
+  void Gemv(const T *x, const T *w, int k, int n, int stride, T *y,
+            const T *bias) const override {
+    simd::Gemv(x, w, k, n, stride, y, bias);
+  }
+  void GemvSigmoid(const T *x, const T *w, int k, int n, int stride, T *y,
+                   const T *bias, const SigmoidMode &mode) const override {
+    simd::GemvSigmoid(x, w, k, n, stride, y, bias, mode);
+  }
+  void GemvSparse(const T *values, const int *index, int nnz, const T *w,
+                  int n, int stride, T *y, const T *bias) const override {
+    simd::GemvSparse(values, index, nnz, w, n, stride, y, bias);
+  }
+  void GemvSparseSigmoid(const T *values, const int *index, int nnz,
+                         const T *w, int n, int stride, T *y, const T *bias,
+                         const SigmoidMode &mode) const override {
+    simd::GemvSparseSigmoid(values, index, nnz, w, n, stride, y, bias, mode);
+  }
+  void GemvTransposed(const T *x, const T *w, int k, int n, int stride,
+                      T *y) const override {
+    simd::GemvTransposed(x, w, k, n, stride, y);
+  }
+  void Gemm(int m, int n, int k, T alpha, const Operand<T> &a,
+            const Operand<T> &b, T beta, T *c, int ldc) const override {
+    simd::Gemm(m, n, k, alpha, a, b, beta, c, ldc);
+  }
+  void Ger(int m, int n, T alpha, const T *x, const T *y, T *a,
+           int lda) const override {
+    simd::Ger(m, n, alpha, x, y, a, lda);
+  }
+  void Sigmoid(T *data, int n, const SigmoidMode &mode) const override {
+    simd::Sigmoid(data, n, mode);
+  }
+  void Softmax(T *data, int n, const SigmoidMode &mode) const override {
+    simd::Softmax(data, n, mode);
+  }
+  void Activate(T *data, int n, const Activation &activation,
+                const SigmoidMode &mode) const override {
+    simd::Activate(data, n, activation, mode);
+  }
+  void ActivationDerivative(const T *output, T *delta, int n,
+                            const Activation &activation) const override {
+    simd::ActivationDerivative(output, delta, n, activation);
+  }
+  void MomentumStep(T *w, const T *d, T *v, int n, T lr, T mu,
+                    bool nesterov) const override {
+    simd::MomentumStep(w, d, v, n, lr, mu, nesterov);
+  }
+  void AdamStep(T *w, const T *d, T *m, T *s, int n, T step, T beta1,
+                T beta2, T epsilon) const override {
+    simd::AdamStep(w, d, m, s, n, step, beta1, beta2, epsilon);
+  }
+};
+
+/*––––––––––– cblas ––––––––––––––––––––––––––––––––––––––––––––––––––––––––*/
+
+#ifdef S21_WITH_CBLAS
+
+void BlasGemv(int k, int n, const float *w, int stride, const float *x,
+              float beta, float *y) {
+  cblas_sgemv(CblasRowMajor, CblasTrans, k, n, 1, w, stride, x, 1, beta, y,
+              1);
+}
+
+/*---y = W x для W из n строк по k, то есть x * W^T---*/
+void BlasGemvTransposed(int k, int n, const float *w, int stride,
+                        const float *x, float *y) {
+  cblas_sgemv(CblasRowMajor, CblasNoTrans, n, k, 1, w, stride, x, 1, 0, y,
+              1);
+}
+
+void BlasGemvTransposed(int k, int n, const double *w, int stride,
+                        const double *x, double *y) {
+  cblas_dgemv(CblasRowMajor, CblasNoTrans, n, k, 1, w, stride, x, 1, 0, y,
+              1);
+}
+
+void BlasGemv(int k, int n, const double *w, int stride, const double *x,
+              double beta, double *y) {
+  cblas_dgemv(CblasRowMajor, CblasTrans, k, n, 1, w, stride, x, 1, beta, y,
+              1);
+}
+
+void BlasGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b, int m, int n,
+              int k, float alpha, const float *a, int lda, const float *b,
+              int ldb, float beta, float *c, int ldc) {
+  cblas_sgemm(CblasRowMajor, trans_a, trans_b, m, n, k, alpha, a, lda, b, ldb,
+              beta, c, ldc);
+}
+
+void BlasGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b, int m, int n,
+              int k, double alpha, const double *a, int lda, const double *b,
+              int ldb, double beta, double *c, int ldc) {
+  cblas_dgemm(CblasRowMajor, trans_a, trans_b, m, n, k, alpha, a, lda, b, ldb,
+              beta, c, ldc);
+}
+
+void BlasGer(int m, int n, float alpha, const float *x, const float *y,
+             float *a, int lda) {
+  cblas_sger(CblasRowMajor, m, n, alpha, x, 1, y, 1, a, lda);
+}
+
+void BlasGer(int m, int n, double alpha, const double *x, const double *y,
+             double *a, int lda) {
+  cblas_dger(CblasRowMajor, m, n, alpha, x, 1, y, 1, a, lda);
+}
+
+/*---операнд в терминах blas: строки подряд или транспонированная матрица,
+ * иначе false---*/
+template <class T>
+bool AsBlasOperand(const Operand<T> &operand, CBLAS_TRANSPOSE *trans,
+                   int *ld) {
+  if (operand.col_stride == 1) {
+    *trans = CblasNoTrans;
+    *ld = operand.row_stride;
+    return true;
+  }
+  if (operand.row_stride == 1) {
+    *trans = CblasTrans;
+    *ld = operand.col_stride;
+    return true;
+  }
+  return false;
+}
+
+template <class T>
+class CblasBackend : public ComputeBackend<T> {
+ public:
+  BackendType get_type() const override { return BackendType::kCblas; }
+
+  void Gemv(const T *x, const T *w, int k, int n, int stride, T *y,
+            const T *bias) const override {
+    if (bias) std::memcpy(y, bias, n * sizeof(T));
+    BlasGemv(k, n, w, stride, x, bias ? 1 : 0, y);
+  }
+  /*---разреженных произведений в blas нет, их считают векторные ядра---*/
+  void GemvSparse(const T *values, const int *index, int nnz, const T *w,
+                  int n, int stride, T *y, const T *bias) const override {
+    simd::GemvSparse(values, index, nnz, w, n, stride, y, bias);
+  }
+  void GemvTransposed(const T *x, const T *w, int k, int n, int stride,
+                      T *y) const override {
+    BlasGemvTransposed(k, n, w, stride, x, y);
+  }
+  void Gemm(int m, int n, int k, T alpha, const Operand<T> &a,
+            const Operand<T> &b, T beta, T *c, int ldc) const override {
+    CBLAS_TRANSPOSE trans_a, trans_b;
+    int lda, ldb;
+    if (AsBlasOperand(a, &trans_a, &lda) &&
+        AsBlasOperand(b, &trans_b, &ldb)) {
+      BlasGemm(trans_a, trans_b, m, n, k, alpha, a.data, lda, b.data, ldb,
+               beta, c, ldc);
+    } else {
+      simd::Gemm(m, n, k, alpha, a, b, beta, c, ldc);
+    }
+  }
+  /*---строки с нулевым x[i] blas не пропускает, поэтому в ger идут только
+   * отрезки подряд идущих ненулевых x: разреженный вход стоит только своих
+   * ненулевых строк, а нули x не трогают строки даже при NaN в y---*/
+  void Ger(int m, int n, T alpha, const T *x, const T *y, T *a,
+           int lda) const override {
+    int i = 0;
+    while (i < m) {
+      if (x[i] == 0) {
+        ++i;
+        continue;
+      }
+      int first = i;
+      while (i < m && x[i] != 0) ++i;
+      BlasGer(i - first, n, alpha, x + first, y, a + (size_t)first * lda,
+              lda);
+    }
+  }
+  /*---в blas нет функций активации и шагов оптимизаторов, их считают
+   * векторные ядра---*/
+  void Sigmoid(T *data, int n, const SigmoidMode &mode) const override {
+    simd::Sigmoid(data, n, mode);
+  }
+  void Softmax(T *data, int n, const SigmoidMode &mode) const override {
+    simd::Softmax(data, n, mode);
+  }
+  void Activate(T *data, int n, const Activation &activation,
+                const SigmoidMode &mode) const override {
+    simd::Activate(data, n, activation, mode);
+  }
+  void ActivationDerivative(const T *output, T *delta, int n,
+                            const Activation &activation) const override {
+    simd::ActivationDerivative(output, delta, n, activation);
+  }
+  void MomentumStep(T *w, const T *d, T *v, int n, T lr, T mu,
+                    bool nesterov) const override {
+    simd::MomentumStep(w, d, v, n, lr, mu, nesterov);
+  }
+  void AdamStep(T *w, const T *d, T *m, T *s, int n, T step, T beta1,
+                T beta2, T epsilon) const override {
+    simd::AdamStep(w, d, m, s, n, step, beta1, beta2, epsilon);
+  }
+};
+
+#endif  // S21_WITH_CBLAS
+
+}  // namespace
+
+bool IsBackendAvailable(const BackendType &type) {
+  switch (type) {
+    case BackendType::kReference:
+    case BackendType::kSimd:
+      return true;
+    case BackendType::kCblas:
+#ifdef S21_WITH_CBLAS
+      return true;
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+const char *BackendName(const BackendType &type) {
+  switch (type) {
+    case BackendType::kReference:
+      return "reference";
+    case BackendType::kSimd:
+      return "simd";
+    case BackendType::kCblas:
+      return "cblas";
+  }
+  return "unknown";
+}
+
+template <class T>
+const ComputeBackend<T> &GetBackend(const BackendType &type) {
+  static const ReferenceBackend<T> reference_backend;
+  static const SimdBackend<T> simd_backend;
+#ifdef S21_WITH_CBLAS
+  static const CblasBackend<T> cblas_backend;
+#endif
+  switch (type) {
+    case BackendType::kReference:
+      return reference_backend;
+    case BackendType::kSimd:
+      return simd_backend;
+#ifdef S21_WITH_CBLAS
+    case BackendType::kCblas:
+      return cblas_backend;
+#endif
+    default:
+      throw std::invalid_argument(
+          std::string("ERROR, backend isn't built in: ") + BackendName(type));
+  }
+}
+
+template const ComputeBackend<float> &GetBackend<float>(
+    const BackendType &type);
+template const ComputeBackend<double> &GetBackend<double>(
+    const BackendType &type);
+
+BackendType ActiveBackendType() { return active_backend; }
+
+BackendScope::BackendScope(const BackendType &type)
+    : previous_(active_backend) {
+  if (!IsBackendAvailable(type)) {
+    throw std::invalid_argument(
+        std::string("ERROR, backend isn't built in: ") + BackendName(type));
+  }
+  active_backend = type;
+}
+
+BackendScope::~BackendScope() { active_backend = previous_; }
+
+}  // namespace s21_kernels
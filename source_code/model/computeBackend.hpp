@@ -0,0 +1,100 @@
+#pragma once
+
+#include "matrixKernels.hpp"
+
+namespace s21_kernels {
+
+/*---реализации вычислительных примитивов матричного движка:
+ *   kReference - простые циклы, эталон для проверки остальных
+ *   kSimd      - блочные векторные ядра из matrixKernels.cpp
+ *   kCblas     - установленная в системе CBLAS, собирается только с
+ *                S21_WITH_CBLAS (qmake CONFIG+=s21_cblas)---*/
+enum class BackendType { kReference, kSimd, kCblas };
+
+template <class T>
+class ComputeBackend {
+ public:
+  virtual ~ComputeBackend() {}
+
+  virtual BackendType get_type() const = 0;
+
+  /*---y[0..n) = x[0..k) * W (+ bias), W - k x n с шагом строк stride---*/
+  virtual void Gemv(const T *x, const T *w, int k, int n, int stride, T *y,
+                    const T *bias) const = 0;
+  /*---то же с сигмоидой от y; бэкенды, которые не умеют считать их
+   * вместе, оставляют эту реализацию---*/
+  virtual void GemvSigmoid(const T *x, const T *w, int k, int n, int stride,
+                           T *y, const T *bias,
+                           const SigmoidMode &mode) const {
+    Gemv(x, w, k, n, stride, y, bias);
+    Sigmoid(y, n, mode);
+  }
+  /*---y[0..n) = x * W (+ bias) для разреженного x: nnz значений в строках
+   * W с возрастающими индексами---*/
+  virtual void GemvSparse(const T *values, const int *index, int nnz,
+                          const T *w, int n, int stride, T *y,
+                          const T *bias) const = 0;
+  virtual void GemvSparseSigmoid(const T *values, const int *index, int nnz,
+                                 const T *w, int n, int stride, T *y,
+                                 const T *bias,
+                                 const SigmoidMode &mode) const {
+    GemvSparse(values, index, nnz, w, n, stride, y, bias);
+    Sigmoid(y, n, mode);
+  }
+  /*---y[0..n) = x[0..k) * W^T, W - n x k с шагом строк stride---*/
+  virtual void GemvTransposed(const T *x, const T *w, int k, int n,
+                              int stride, T *y) const = 0;
+  /*---C (m x n) = alpha * A (m x k) * B (k x n) + beta * C, при beta == 0
+   * C не читается---*/
+  virtual void Gemm(int m, int n, int k, T alpha, const Operand<T> &a,
+                    const Operand<T> &b, T beta, T *c, int ldc) const = 0;
+  /*---A (m x n) += alpha * x^T * y, строки с x[i] == 0 не меняются---*/
+  virtual void Ger(int m, int n, T alpha, const T *x, const T *y, T *a,
+                   int lda) const = 0;
+  /*---активация: data[0..n) = sigmoid(data[0..n))---*/
+  virtual void Sigmoid(T *data, int n, const SigmoidMode &mode) const = 0;
+  /*---data[0..n) = softmax(data[0..n)) со сдвигом на максимум---*/
+  virtual void Softmax(T *data, int n, const SigmoidMode &mode) const = 0;
+  /*---data[0..n) = f(data[0..n)) и delta[0..n) *= f' через выходы, см.
+   * matrixKernels.hpp---*/
+  virtual void Activate(T *data, int n, const Activation &activation,
+                        const SigmoidMode &mode) const = 0;
+  virtual void ActivationDerivative(const T *output, T *delta, int n,
+                                    const Activation &activation) const = 0;
+  /*---шаги оптимизаторов, см. matrixKernels.hpp---*/
+  virtual void MomentumStep(T *w, const T *d, T *v, int n, T lr, T mu,
+                            bool nesterov) const = 0;
+  virtual void AdamStep(T *w, const T *d, T *m, T *s, int n, T step, T beta1,
+                        T beta2, T epsilon) const = 0;
+};
+
+bool IsBackendAvailable(const BackendType &type);
+const char *BackendName(const BackendType &type);
+
+/*---по одному общему экземпляру на бэкенд; std::invalid_argument, если
+ * бэкенда нет в этой сборке---*/
+template <class T>
+const ComputeBackend<T> &GetBackend(const BackendType &type);
+
+/*---бэкенд функций s21_kernels в вызывающем потоке: kSimd, если в этом
+ * потоке BackendScope не выбрал другой---*/
+BackendType ActiveBackendType();
+template <class T>
+const ComputeBackend<T> &ActiveBackend() {
+  return GetBackend<T>(ActiveBackendType());
+}
+
+/*---переключает вызывающий поток на другой бэкенд до конца области
+ * видимости, области могут быть вложенными---*/
+class BackendScope {
+ public:
+  explicit BackendScope(const BackendType &type);
+  ~BackendScope();
+  BackendScope(const BackendScope &) = delete;
+  BackendScope &operator=(const BackendScope &) = delete;
+
+ private:
+  BackendType previous_;
+};
+
+}  // namespace s21_kernels
@@ -0,0 +1,713 @@
+#include "fixedNetwork.hpp"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <sstream>
+
+/*---S21_KERNELS_NO_SIMD оставляет только переносимые циклы---*/
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    !defined(S21_KERNELS_NO_SIMD)
+#define S21_FIXED_X86
+#endif
+
+namespace s21_network {
+
+namespace {
+
+namespace scalar {
+
+#define S21_SIMD_TARGET
+#define S21_SIMD_BYTES 16
+#include "fixedNetworkLayers.inc"
+#undef S21_SIMD_BYTES
+#undef S21_SIMD_TARGET
+
+}  // namespace scalar
+
+#ifdef S21_FIXED_X86
+
+namespace avx2 {
+
+#define S21_SIMD_TARGET __attribute__((target("avx2,fma")))
+#define S21_SIMD_BYTES 32
+#include "fixedNetworkLayers.inc"
+#undef S21_SIMD_BYTES
+#undef S21_SIMD_TARGET
+
+}  // namespace avx2
+
+namespace avx512 {
+
+#define S21_SIMD_TARGET __attribute__((target("avx512f,avx2,fma")))
+#define S21_SIMD_BYTES 64
+#include "fixedNetworkLayers.inc"
+#undef S21_SIMD_BYTES
+#undef S21_SIMD_TARGET
+
+}  // namespace avx512
+
+#endif  // S21_FIXED_X86
+
+/*---слои считает тот же набор инструкций, что и ядра s21_kernels---*/
+template <unsigned kRows, unsigned kColumns, unsigned kStride, typename T>
+void MulLayer(const s21_kernels::SimdLevel &level, const T *x, const T *w,
+              T *y) {
+  switch (level) {
+#ifdef S21_FIXED_X86
+    case s21_kernels::SimdLevel::kAvx512:
+      return avx512::MulLayer<kRows, kColumns, kStride>(x, w, y);
+    case s21_kernels::SimdLevel::kAvx2:
+      return avx2::MulLayer<kRows, kColumns, kStride>(x, w, y);
+#endif
+    default:
+      return scalar::MulLayer<kRows, kColumns, kStride>(x, w, y);
+  }
+}
+
+template <unsigned kRows, unsigned kColumns, unsigned kStride, typename T>
+void MulLayerTransposed(const s21_kernels::SimdLevel &level, const T *d,
+                        const T *w, T *y) {
+  switch (level) {
+#ifdef S21_FIXED_X86
+    case s21_kernels::SimdLevel::kAvx512:
+      return avx512::MulLayerTransposed<kRows, kColumns, kStride>(d, w, y);
+    case s21_kernels::SimdLevel::kAvx2:
+      return avx2::MulLayerTransposed<kRows, kColumns, kStride>(d, w, y);
+#endif
+    default:
+      return scalar::MulLayerTransposed<kRows, kColumns, kStride>(d, w, y);
+  }
+}
+
+template <unsigned kRows, unsigned kColumns, unsigned kStride, typename T>
+void CorrectLayer(const s21_kernels::SimdLevel &level, const T *x,
+                  const T *d, const T &rate, Optimizer<T> *optimizer,
+                  T *direction, T *w) {
+  switch (level) {
+#ifdef S21_FIXED_X86
+    case s21_kernels::SimdLevel::kAvx512:
+      return avx512::CorrectLayer<kRows, kColumns, kStride>(
+          x, d, rate, optimizer, direction, w);
+    case s21_kernels::SimdLevel::kAvx2:
+      return avx2::CorrectLayer<kRows, kColumns, kStride>(
+          x, d, rate, optimizer, direction, w);
+#endif
+    default:
+      return scalar::CorrectLayer<kRows, kColumns, kStride>(
+          x, d, rate, optimizer, direction, w);
+  }
+}
+
+template <unsigned kDepth>
+InterfaceNetwork *CreateFixedDepth(const double &learning_rate,
+                                   const ScalarType &scalar_type) {
+  if (scalar_type == ScalarType::kFloat) {
+    return new FixedNetwork<kInputLayer, kSumNeironsHiddenLayer, kDepth,
+                            kSumNeironsOutputLayer, float>(learning_rate);
+  }
+  return new FixedNetwork<kInputLayer, kSumNeironsHiddenLayer, kDepth,
+                          kSumNeironsOutputLayer, double>(learning_rate);
+}
+
+}  // namespace
+
+InterfaceNetwork *CreateFixedNetwork(const int &sum_hidden_layers,
+                                     const double &learning_rate,
+                                     const ScalarType &scalar_type) {
+  switch (sum_hidden_layers) {
+    case 2:
+      return CreateFixedDepth<2>(learning_rate, scalar_type);
+    case 3:
+      return CreateFixedDepth<3>(learning_rate, scalar_type);
+    case 4:
+      return CreateFixedDepth<4>(learning_rate, scalar_type);
+    case 5:
+      return CreateFixedDepth<5>(learning_rate, scalar_type);
+    default:
+      throw std::invalid_argument(
+          "Error, fixed network isn't built with " +
+          std::to_string(sum_hidden_layers) + " hidden layers");
+  }
+}
+
+/*––––––––––– class FixedNetwork ––––––––––––––––––*/
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+FixedNetwork<In, Hidden, Depth, Out, T>::FixedNetwork(
+    const double &learning_rate)
+    : input_weights_{},
+      hidden_weights_{},
+      output_weights_{},
+      learning_rate_(learning_rate),
+      simd_level_(s21_kernels::ActiveSimdLevel()) {
+  activations_.fill(s21_kernels::Activation::kSigmoid);
+  optimizers_.fill(nullptr);
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+FixedNetwork<In, Hidden, Depth, Out, T>::~FixedNetwork() {
+  for (Optimizer<T> *optimizer : optimizers_) {
+    if (optimizer != nullptr) {
+      delete optimizer;
+    }
+  }
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+void FixedNetwork<In, Hidden, Depth, Out, T>::InstallRandomWeights() {
+  InstallRandomWeights(time(NULL));
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+void FixedNetwork<In, Hidden, Depth, Out, T>::InstallRandomWeights(
+    const unsigned &seed) {
+  srand(seed);
+  for (unsigned layer = 0; layer < kSumLayers; ++layer) {
+    unsigned rows = layer_rows(layer);
+    unsigned columns = layer_columns(layer);
+    /*---разброс как у MatrixNetwork: у ReLU и tanh он сужается по числу
+     * входов (He и Glorot), у выходного слоя нет---*/
+    double scale = 1;
+    if (layer < Depth) {
+      if (activations_[layer] == s21_kernels::Activation::kRelu ||
+          activations_[layer] == s21_kernels::Activation::kLeakyRelu) {
+        scale = std::sqrt(6.0 / rows);
+      } else if (activations_[layer] == s21_kernels::Activation::kTanh) {
+        scale = std::sqrt(6.0 / (rows + columns));
+      }
+    }
+    T *weights = layer_weights(layer);
+    for (unsigned i = 0; i < rows; ++i) {
+      T *row = weights + (size_t)i * layer_stride(layer);
+      for (unsigned j = 0; j < columns; ++j) {
+        row[j] = (rand() % 201 - 100) * 0.01 * scale;
+      }
+    }
+  }
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+void FixedNetwork<In, Hidden, Depth, Out, T>::LoadWeights(
+    const std::string &filename) {
+  std::ifstream stream(filename);
+  if (stream.is_open()) {
+    setlocale(LC_ALL, "en_US.UTF-8");
+    /*---формат файла тот же, что у MatrixNetwork---*/
+    std::string line{};
+    std::getline(stream, line);
+    if (line != "Weights Network") {
+      throw std::invalid_argument("The file isn't a weights for the Network");
+    }
+    std::getline(stream, line);
+    if (line != std::to_string(Depth) + " Hiddens Layers") {
+      throw std::invalid_argument(
+          "Error, current Network have " + std::to_string(Depth) +
+          " hidden Layers. But you try load Network with " + line +
+          ", switch current Network, if u wanna load this file with weights.");
+    }
+    /*---файл читается целиком во временные массивы, сеть меняется только
+     * после последнего слоя: ошибка в файле не оставит ее загруженной
+     * наполовину---*/
+    std::vector<s21_kernels::Activation> activations =
+        ReadActivations(&stream, Depth);
+    std::array<std::vector<T>, kSumLayers> layers{};
+    for (unsigned layer = 0; layer < kSumLayers; ++layer) {
+      const T *weights = layer_weights(layer);
+      layers[layer].assign(
+          weights, weights + (size_t)layer_rows(layer) * layer_stride(layer));
+      LoadLayer(&stream, layer, &layers[layer]);
+    }
+    std::copy(activations.begin(), activations.end(), activations_.begin());
+    for (unsigned layer = 0; layer < kSumLayers; ++layer) {
+      std::copy(layers[layer].begin(), layers[layer].end(),
+                layer_weights(layer));
+    }
+    stream.close();
+  }
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+void FixedNetwork<In, Hidden, Depth, Out, T>::SaveWeights(
+    const std::string &filename) {
+  std::ofstream stream(filename);
+  if (stream.is_open()) {
+    setlocale(LC_ALL, "en_US.UTF-8");
+    stream << "Weights Network" << std::endl;
+    stream << std::to_string(Depth) + " Hiddens Layers" << std::endl;
+    WriteActivations(std::vector<s21_kernels::Activation>(
+                         activations_.begin(), activations_.end()),
+                     &stream);
+    for (unsigned layer = 0; layer < kSumLayers; ++layer) {
+      SaveLayer(&stream, layer);
+    }
+    stream.close();
+  }
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+std::vector<double> FixedNetwork<In, Hidden, Depth, Out, T>::GetWeights()
+    const {
+  std::vector<double> weights{};
+  weights.reserve(kSumWeights);
+  for (unsigned layer = 0; layer < kSumLayers; ++layer) {
+    for (unsigned i = 0; i < layer_rows(layer); ++i) {
+      const T *row = layer_weights(layer) + (size_t)i * layer_stride(layer);
+      weights.insert(weights.end(), row, row + layer_columns(layer));
+    }
+  }
+  return weights;
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+void FixedNetwork<In, Hidden, Depth, Out, T>::SetWeights(
+    const std::vector<double> &weights) {
+  if (weights.size() != kSumWeights) {
+    throw std::invalid_argument(
+        "Error in SetWeights(), network has " + std::to_string(kSumWeights) +
+        " weights, but got " + std::to_string(weights.size()));
+  }
+  size_t offset = 0;
+  for (unsigned layer = 0; layer < kSumLayers; ++layer) {
+    for (unsigned i = 0; i < layer_rows(layer); ++i) {
+      T *row = layer_weights(layer) + (size_t)i * layer_stride(layer);
+      for (unsigned j = 0; j < layer_columns(layer); ++j) {
+        row[j] = weights[offset++];
+      }
+    }
+  }
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+size_t FixedNetwork<In, Hidden, Depth, Out, T>::Prediction(
+    const std::vector<unsigned> &input_layer) {
+  SetInput(input_layer, &signals_);
+  FeedForward(&signals_);
+  return ResultNeiron(signals_);
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+void FixedNetwork<In, Hidden, Depth, Out, T>::PredictBatch(
+    const uint8_t *pixels, const size_t &n, size_t *out_labels) {
+  for (size_t i = 0; i < n; ++i) {
+    SetInput(pixels + i * In, &signals_);
+    FeedForward(&signals_);
+    out_labels[i] = ResultNeiron(signals_);
+  }
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+InferenceWorkspace *FixedNetwork<In, Hidden, Depth, Out, T>::CreateWorkspace()
+    const {
+  return new Workspace();
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+size_t FixedNetwork<In, Hidden, Depth, Out, T>::Prediction(
+    const std::vector<unsigned> &input_layer,
+    InferenceWorkspace *workspace) const {
+  Workspace *own = CheckWorkspace(workspace);
+  SetInput(input_layer, &own->signals);
+  FeedForward(&own->signals);
+  return ResultNeiron(own->signals);
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+void FixedNetwork<In, Hidden, Depth, Out, T>::PredictBatch(
+    const uint8_t *pixels, const size_t &n, size_t *out_labels,
+    InferenceWorkspace *workspace) const {
+  Workspace *own = CheckWorkspace(workspace);
+  for (size_t i = 0; i < n; ++i) {
+    SetInput(pixels + i * In, &own->signals);
+    FeedForward(&own->signals);
+    out_labels[i] = ResultNeiron(own->signals);
+  }
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+void FixedNetwork<In, Hidden, Depth, Out, T>::LearnNetwork(
+    const std::vector<unsigned> &input_layer, const size_t &expected_value) {
+  SetInput(input_layer, &signals_);
+  FeedForward(&signals_);
+  CorrectWeights(expected_value, signals_, &deltas_);
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+void FixedNetwork<In, Hidden, Depth, Out, T>::LearnNetwork(
+    const std::vector<unsigned> &input_layer, const size_t &expected_value,
+    InferenceWorkspace *workspace) {
+  Workspace *own = CheckWorkspace(workspace);
+  if (optimizer_config_.type != OptimizerType::kSgd) {
+    throw std::invalid_argument(
+        "Error, learning with a workspace needs the plain SGD step");
+  }
+  SetInput(input_layer, &own->signals);
+  FeedForward(&own->signals);
+  CorrectWeights(expected_value, own->signals, &own->deltas);
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+void FixedNetwork<In, Hidden, Depth, Out, T>::PredictProbabilities(
+    const std::vector<unsigned> &input_layer,
+    std::vector<double> *probabilities) {
+  SetInput(input_layer, &signals_);
+  FeedForward(&signals_);
+  probabilities->assign(signals_.output.begin(), signals_.output.end());
+  if (output_type_ == OutputType::kSigmoid) {
+    double sum = 0;
+    for (double value : *probabilities) sum += value;
+    for (double &value : *probabilities) value /= sum;
+  }
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+void FixedNetwork<In, Hidden, Depth, Out, T>::set_output_type(
+    const OutputType &type) {
+  output_type_ = type;
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+OutputType FixedNetwork<In, Hidden, Depth, Out, T>::get_output_type() const {
+  return output_type_;
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+void FixedNetwork<In, Hidden, Depth, Out, T>::set_activation(
+    const size_t &layer, const s21_kernels::Activation &activation) {
+  CheckHiddenLayer(layer);
+  activations_[layer] = activation;
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+s21_kernels::Activation FixedNetwork<In, Hidden, Depth, Out, T>::get_activation(
+    const size_t &layer) const {
+  CheckHiddenLayer(layer);
+  return activations_[layer];
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+void FixedNetwork<In, Hidden, Depth, Out, T>::set_sigmoid_mode(
+    const s21_kernels::SigmoidMode &mode) {
+  sigmoid_mode_ = mode;
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+s21_kernels::SigmoidMode
+FixedNetwork<In, Hidden, Depth, Out, T>::get_sigmoid_mode() const {
+  return sigmoid_mode_;
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+void FixedNetwork<In, Hidden, Depth, Out, T>::set_optimizer(
+    const OptimizerConfig &config) {
+  /*---все оптимизаторы создаются до замены старых, ошибка в параметрах
+   * не оставит сеть с частью новых---*/
+  std::array<Optimizer<T> *, kSumLayers> optimizers{};
+  for (unsigned layer = 0; layer < kSumLayers; ++layer) {
+    optimizers[layer] = Optimizer<T>::Create(config);
+  }
+  for (unsigned layer = 0; layer < kSumLayers; ++layer) {
+    if (optimizers_[layer] != nullptr) {
+      delete optimizers_[layer];
+    }
+    optimizers_[layer] = optimizers[layer];
+  }
+  size_t max_size = 0;
+  for (unsigned layer = 0; layer < kSumLayers; ++layer) {
+    max_size = std::max(max_size,
+                        (size_t)layer_rows(layer) * layer_stride(layer));
+  }
+  direction_.assign(optimizers_[0] != nullptr ? max_size : 0, 0);
+  optimizer_config_ = config;
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+OptimizerConfig FixedNetwork<In, Hidden, Depth, Out, T>::get_optimizer()
+    const {
+  return optimizer_config_;
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+void FixedNetwork<In, Hidden, Depth, Out, T>::set_learning_rate(
+    const double &learning_rate) {
+  if (learning_rate > 0) learning_rate_ = learning_rate;
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+double FixedNetwork<In, Hidden, Depth, Out, T>::get_learning_rate() const {
+  return learning_rate_;
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+InterfaceNetwork *FixedNetwork<In, Hidden, Depth, Out, T>::Clone() const {
+  auto *copy = new FixedNetwork(learning_rate_);
+  CopySettings(Depth, copy);
+  return copy;
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+typename FixedNetwork<In, Hidden, Depth, Out, T>::Workspace *
+FixedNetwork<In, Hidden, Depth, Out, T>::CheckWorkspace(
+    InferenceWorkspace *workspace) const {
+  Workspace *own = dynamic_cast<Workspace *>(workspace);
+  if (own == nullptr) {
+    throw std::invalid_argument(
+        "Error, workspace wasn't created by this network");
+  }
+  return own;
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+void FixedNetwork<In, Hidden, Depth, Out, T>::CheckHiddenLayer(
+    const size_t &layer) {
+  if (layer >= Depth) {
+    throw std::out_of_range("Error, network has " + std::to_string(Depth) +
+                            " hidden layers, no layer " +
+                            std::to_string(layer));
+  }
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+T *FixedNetwork<In, Hidden, Depth, Out, T>::layer_weights(
+    const unsigned &layer) {
+  if (layer == 0) return input_weights_.data();
+  if (layer < Depth) return hidden_weights_[layer - 1].data();
+  return output_weights_.data();
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+const T *FixedNetwork<In, Hidden, Depth, Out, T>::layer_weights(
+    const unsigned &layer) const {
+  if (layer == 0) return input_weights_.data();
+  if (layer < Depth) return hidden_weights_[layer - 1].data();
+  return output_weights_.data();
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+unsigned FixedNetwork<In, Hidden, Depth, Out, T>::layer_rows(
+    const unsigned &layer) {
+  return layer == 0 ? In : Hidden;
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+unsigned FixedNetwork<In, Hidden, Depth, Out, T>::layer_columns(
+    const unsigned &layer) {
+  return layer < Depth ? Hidden : Out;
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+unsigned FixedNetwork<In, Hidden, Depth, Out, T>::layer_stride(
+    const unsigned &layer) {
+  return layer < Depth ? kHiddenStride : kOutStride;
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+void FixedNetwork<In, Hidden, Depth, Out, T>::SetInput(
+    const std::vector<unsigned> &input_layer, Signals *signals) {
+  if (input_layer.size() != In) {
+    throw std::invalid_argument(
+        "Error, size of input layer must be " + std::to_string(In) +
+        ", but got " + std::to_string(input_layer.size()));
+  }
+  for (unsigned i = 0; i < In; ++i) {
+    signals->input[i] = (T)input_layer[i] / 255;
+  }
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+void FixedNetwork<In, Hidden, Depth, Out, T>::SetInput(const uint8_t *pixels,
+                                                       Signals *signals) {
+  for (unsigned i = 0; i < In; ++i) {
+    signals->input[i] = (T)pixels[i] / 255;
+  }
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+void FixedNetwork<In, Hidden, Depth, Out, T>::FeedForward(
+    Signals *signals) const {
+  MulLayer<In, Hidden, kHiddenStride>(simd_level_, signals->input.data(),
+                                      input_weights_.data(),
+                                      signals->hidden[0].data());
+  s21_kernels::Activate(signals->hidden[0].data(), Hidden, activations_[0],
+                        sigmoid_mode_);
+  for (unsigned layer = 1; layer < Depth; ++layer) {
+    MulLayer<Hidden, Hidden, kHiddenStride>(
+        simd_level_, signals->hidden[layer - 1].data(),
+        hidden_weights_[layer - 1].data(), signals->hidden[layer].data());
+    s21_kernels::Activate(signals->hidden[layer].data(), Hidden,
+                          activations_[layer], sigmoid_mode_);
+  }
+  MulLayer<Hidden, Out, kOutStride>(simd_level_,
+                                    signals->hidden[Depth - 1].data(),
+                                    output_weights_.data(),
+                                    signals->output.data());
+  if (output_type_ == OutputType::kSoftmax) {
+    s21_kernels::Softmax(signals->output.data(), Out, sigmoid_mode_);
+  } else {
+    s21_kernels::Sigmoid(signals->output.data(), Out, sigmoid_mode_);
+  }
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+size_t FixedNetwork<In, Hidden, Depth, Out, T>::ResultNeiron(
+    const Signals &signals) {
+  /*---ответы нумеруются с единицы---*/
+  return std::max_element(signals.output.begin(), signals.output.end()) -
+         signals.output.begin() + 1;
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+void FixedNetwork<In, Hidden, Depth, Out, T>::CorrectWeights(
+    const size_t &expected_value, const Signals &signals, Deltas *deltas) {
+  /*---дельта выхода: у kSoftmax target - output, у kSigmoid еще множитель
+   * производной сигмоиды---*/
+  for (unsigned j = 0; j < Out; ++j) {
+    T target = ((size_t)j + 1 == expected_value) ? 1 : 0;
+    T output = signals.output[j];
+    deltas->output[j] = target - output;
+    if (output_type_ == OutputType::kSigmoid) {
+      deltas->output[j] *= output * (1 - output);
+    }
+  }
+
+  /*---дельты скрытых слоев от последнего к первому, пока веса еще не
+   * изменены---*/
+  MulLayerTransposed<Hidden, Out, kOutStride>(
+      simd_level_, deltas->output.data(), output_weights_.data(),
+      deltas->hidden[Depth - 1].data());
+  s21_kernels::ActivationDerivative(signals.hidden[Depth - 1].data(),
+                                    deltas->hidden[Depth - 1].data(), Hidden,
+                                    activations_[Depth - 1]);
+  for (unsigned layer = Depth - 1; layer > 0; --layer) {
+    MulLayerTransposed<Hidden, Hidden, kHiddenStride>(
+        simd_level_, deltas->hidden[layer].data(),
+        hidden_weights_[layer - 1].data(), deltas->hidden[layer - 1].data());
+    s21_kernels::ActivationDerivative(signals.hidden[layer - 1].data(),
+                                      deltas->hidden[layer - 1].data(),
+                                      Hidden, activations_[layer - 1]);
+  }
+
+  /*---затем шаг весов каждого слоя по сигналам предыдущего---*/
+  T *direction = direction_.data();
+  CorrectLayer<Hidden, Out, kOutStride>(
+      simd_level_, signals.hidden[Depth - 1].data(), deltas->output.data(),
+      learning_rate_, optimizers_[Depth], direction, output_weights_.data());
+  for (unsigned layer = Depth - 1; layer > 0; --layer) {
+    CorrectLayer<Hidden, Hidden, kHiddenStride>(
+        simd_level_, signals.hidden[layer - 1].data(),
+        deltas->hidden[layer].data(), learning_rate_, optimizers_[layer],
+        direction, hidden_weights_[layer - 1].data());
+  }
+  CorrectLayer<In, Hidden, kHiddenStride>(
+      simd_level_, signals.input.data(), deltas->hidden[0].data(),
+      learning_rate_, optimizers_[0], direction, input_weights_.data());
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+void FixedNetwork<In, Hidden, Depth, Out, T>::LoadLayer(
+    std::ifstream *stream, const unsigned &layer,
+    std::vector<T> *weights) const {
+  /*---массивы весов фиксированы, поэтому лишняя строка или число в строке
+   * - ошибка файла, а не выход за границу---*/
+  unsigned rows = layer_rows(layer);
+  unsigned columns = layer_columns(layer);
+  std::string line{};
+  unsigned row = 0;
+  while (std::getline(*stream, line) && line != "Layer weights are over") {
+    std::istringstream values(line);
+    unsigned column = 0;
+    double value = 0;
+    while (values >> value) {
+      if (row >= rows || column >= columns) {
+        throw std::invalid_argument(
+            "Error, layer " + std::to_string(layer) +
+            " of the weights file doesn't fit the network");
+      }
+      (*weights)[(size_t)row * layer_stride(layer) + column++] = value;
+    }
+    ++row;
+  }
+}
+
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+void FixedNetwork<In, Hidden, Depth, Out, T>::SaveLayer(
+    std::ofstream *stream, const unsigned &layer) const {
+  unsigned rows = layer_rows(layer);
+  unsigned columns = layer_columns(layer);
+  for (unsigned i = 0; i < rows; ++i) {
+    const T *row = layer_weights(layer) + (size_t)i * layer_stride(layer);
+    for (unsigned j = 0; j < columns; ++j) {
+      if (j != columns - 1) {
+        *stream << row[j] << " ";
+      } else {
+        *stream << row[j] << std::endl;
+      }
+    }
+  }
+  *stream << "Layer weights are over" << std::endl;
+}
+
+/*–––––––––––––––––––––––––––––––––––––––––––––––--*/
+
+/*---собираются только рабочие топологии---*/
+template class FixedNetwork<kInputLayer, kSumNeironsHiddenLayer, 2,
+                            kSumNeironsOutputLayer, float>;
+template class FixedNetwork<kInputLayer, kSumNeironsHiddenLayer, 3,
+                            kSumNeironsOutputLayer, float>;
+template class FixedNetwork<kInputLayer, kSumNeironsHiddenLayer, 4,
+                            kSumNeironsOutputLayer, float>;
+template class FixedNetwork<kInputLayer, kSumNeironsHiddenLayer, 5,
+                            kSumNeironsOutputLayer, float>;
+template class FixedNetwork<kInputLayer, kSumNeironsHiddenLayer, 2,
+                            kSumNeironsOutputLayer, double>;
+template class FixedNetwork<kInputLayer, kSumNeironsHiddenLayer, 3,
+                            kSumNeironsOutputLayer, double>;
+template class FixedNetwork<kInputLayer, kSumNeironsHiddenLayer, 4,
+                            kSumNeironsOutputLayer, double>;
+template class FixedNetwork<kInputLayer, kSumNeironsHiddenLayer, 5,
+                            kSumNeironsOutputLayer, double>;
+
+}  // namespace s21_network
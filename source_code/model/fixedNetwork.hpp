@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "interfaceNetwork.hpp"
+#include "matrixNetwork.hpp"
+
+namespace s21_network {
+
+/*---сеть с размерами слоев, известными при компиляции: In входов, Depth
+ * скрытых слоев по Hidden нейронов, Out выходов. Веса и сигналы лежат в
+ * массивах внутри объекта, циклы слоев идут до констант, поэтому
+ * компилятор разворачивает и векторизует их, а проверок размеров и
+ * указателей на слои нет. Веса, файл весов и обучение те же, что у
+ * MatrixNetwork той же топологии. Объект весит мегабайты, создается через
+ * new. Собраны только рабочие топологии, см. CreateFixedNetwork---*/
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T = double>
+class FixedNetwork : public InterfaceNetwork {
+  static_assert(In > 0 && Hidden > 0 && Depth > 0 && Out > 0,
+                "FixedNetwork needs non-empty layers");
+
+ public:
+  explicit FixedNetwork(const double &learning_rate);
+  virtual ~FixedNetwork();
+
+  void InstallRandomWeights() override;
+  void InstallRandomWeights(const unsigned &seed) override;
+  void LoadWeights(const std::string &filename) override;
+  void SaveWeights(const std::string &filename) override;
+  std::vector<double> GetWeights() const override;
+  void SetWeights(const std::vector<double> &weights) override;
+  size_t Prediction(const std::vector<unsigned> &input_layer) override;
+  void PredictBatch(const uint8_t *pixels, const size_t &n,
+                    size_t *out_labels) override;
+  InferenceWorkspace *CreateWorkspace() const override;
+  size_t Prediction(const std::vector<unsigned> &input_layer,
+                    InferenceWorkspace *workspace) const override;
+  void PredictBatch(const uint8_t *pixels, const size_t &n,
+                    size_t *out_labels,
+                    InferenceWorkspace *workspace) const override;
+  void LearnNetwork(const std::vector<unsigned> &input_layer,
+                    const size_t &expected_value) override;
+  void LearnNetwork(const std::vector<unsigned> &input_layer,
+                    const size_t &expected_value,
+                    InferenceWorkspace *workspace) override;
+  void PredictProbabilities(const std::vector<unsigned> &input_layer,
+                            std::vector<double> *probabilities) override;
+  void set_output_type(const OutputType &type) override;
+  OutputType get_output_type() const override;
+  void set_activation(const size_t &layer,
+                      const s21_kernels::Activation &activation) override;
+  s21_kernels::Activation get_activation(const size_t &layer) const override;
+  void set_sigmoid_mode(const s21_kernels::SigmoidMode &mode) override;
+  s21_kernels::SigmoidMode get_sigmoid_mode() const override;
+  void set_optimizer(const OptimizerConfig &config) override;
+  OptimizerConfig get_optimizer() const override;
+  void set_learning_rate(const double &learning_rate) override;
+  double get_learning_rate() const override;
+  InterfaceNetwork *Clone() const override;
+
+ private:
+  static constexpr unsigned kSumLayers = Depth + 1;  // скрытые и выходной
+  static constexpr size_t kSumWeights =
+      (size_t)In * Hidden + (size_t)(Depth - 1) * Hidden * Hidden +
+      (size_t)Hidden * Out;
+  /*---строки весов начинаются с границы 64 байт, как у S21Matrix: длина
+   * строки округляется вверх, хвост строки всегда нулевой---*/
+  static constexpr unsigned kLineValues = 64 / sizeof(T);
+  static constexpr unsigned kHiddenStride =
+      (Hidden + kLineValues - 1) / kLineValues * kLineValues;
+  static constexpr unsigned kOutStride =
+      (Out + kLineValues - 1) / kLineValues * kLineValues;
+
+  /*---сигналы всех слоев одного прямого прохода---*/
+  struct Signals {
+    alignas(64) std::array<T, In> input;
+    alignas(64) std::array<std::array<T, Hidden>, Depth> hidden;
+    alignas(64) std::array<T, Out> output;
+  };
+  /*---дельты скрытых слоев и выходного слоя одного примера---*/
+  struct Deltas {
+    alignas(64) std::array<std::array<T, Hidden>, Depth> hidden;
+    alignas(64) std::array<T, Out> output;
+  };
+  class Workspace;
+  Workspace *CheckWorkspace(InferenceWorkspace *workspace) const;
+  static void CheckHiddenLayer(const size_t &layer);
+
+  /*---веса слоя, число его входов и нейронов и длина строки весов по
+   * номеру слоя, выходной слой последний---*/
+  T *layer_weights(const unsigned &layer);
+  const T *layer_weights(const unsigned &layer) const;
+  static unsigned layer_rows(const unsigned &layer);
+  static unsigned layer_columns(const unsigned &layer);
+  static unsigned layer_stride(const unsigned &layer);
+
+  static void SetInput(const std::vector<unsigned> &input_layer,
+                       Signals *signals);
+  static void SetInput(const uint8_t *pixels, Signals *signals);
+  /*---прямой проход по signals->input, сама сеть не меняется---*/
+  void FeedForward(Signals *signals) const;
+  static size_t ResultNeiron(const Signals &signals);
+  /*---обратный проход по signals, дельты пишутся в deltas---*/
+  void CorrectWeights(const size_t &expected_value, const Signals &signals,
+                      Deltas *deltas);
+  /*---читает слой в weights - копию весов слоя с тем же шагом строк---*/
+  void LoadLayer(std::ifstream *stream, const unsigned &layer,
+                 std::vector<T> *weights) const;
+  void SaveLayer(std::ofstream *stream, const unsigned &layer) const;
+
+  alignas(64) std::array<T, (size_t)In * kHiddenStride> input_weights_;
+  alignas(64) std::array<std::array<T, (size_t)Hidden * kHiddenStride>,
+                         Depth - 1> hidden_weights_;
+  alignas(64) std::array<T, (size_t)Hidden * kOutStride> output_weights_;
+  Signals signals_;
+  Deltas deltas_;  // последнего примера
+
+  std::array<s21_kernels::Activation, Depth> activations_;
+  OutputType output_type_ = OutputType::kSigmoid;
+  T learning_rate_;
+  OptimizerConfig optimizer_config_{};
+  /*---свой оптимизатор у каждого слоя, nullptr - простой шаг; направление
+   * шага у слоев общее, оно нужно только оптимизатору---*/
+  std::array<Optimizer<T> *, kSumLayers> optimizers_;
+  std::vector<T> direction_{};
+  s21_kernels::SigmoidMode sigmoid_mode_ = s21_kernels::SigmoidMode::kPrecise;
+  s21_kernels::SimdLevel simd_level_;  // набор инструкций циклов слоев
+};
+
+/*---рабочая память константного распознавания - свои сигналы слоев, для
+ * обучения еще свои дельты---*/
+template <unsigned In, unsigned Hidden, unsigned Depth, unsigned Out,
+          typename T>
+class FixedNetwork<In, Hidden, Depth, Out, T>::Workspace
+    : public InferenceWorkspace {
+ public:
+  Signals signals;
+  Deltas deltas;
+};
+
+/*---FixedNetwork рабочей топологии kInputLayer - sum_hidden_layers слоев
+ * по kSumNeironsHiddenLayer - kSumNeironsOutputLayer; собраны сети с 2..5
+ * скрытыми слоями, для другого числа std::invalid_argument---*/
+InterfaceNetwork *CreateFixedNetwork(const int &sum_hidden_layers,
+                                     const double &learning_rate,
+                                     const ScalarType &scalar_type = kDouble);
+
+}  // namespace s21_network
@@ -1,5 +1,6 @@
 #include "graphNetwork.hpp"
 
+#include <cmath>
 #include <cstdlib>
 #include <ctime>
 #include <fstream>
@@ -109,6 +110,7 @@ void GraphNetwork::SetupNetwork(int wdt_in, int num_hid, int wdt_hid,
   CreateOutputLayer(wdt_out);
   ConnectInputHidden();
   ConnectHiddenOutput();
+  ApplyOptimizer();
 }
 
 void GraphNetwork::Clear() {
@@ -125,9 +127,24 @@ void GraphNetwork::ResizeHidden(size_t depth) {
     CreateHiddenLayer(depth, width);
     ConnectInputHidden();
     ConnectHiddenOutput();
+    ApplyOptimizer();
   }
 }
 
+void GraphNetwork::set_activation(const size_t& layer,
+                                  const s21_kernels::Activation& activation) {
+  if (layer >= hidden_layer_.size())
+    throw std::out_of_range("no hidden layer with such index");
+  for (auto i : hidden_layer_[layer]) i->set_mode(ActMode(activation));
+}
+
+s21_kernels::Activation GraphNetwork::get_activation(
+    const size_t& layer) const {
+  if (layer >= hidden_layer_.size())
+    throw std::out_of_range("no hidden layer with such index");
+  return KernelActivation(hidden_layer_[layer].front()->get_mode());
+}
+
 int GraphNetwork::Run(const std::vector<float>& src) {
   if (!is_set_up()) throw std::out_of_range("network not set up");
 
@@ -147,8 +164,43 @@ void GraphNetwork::set_expected_values(const std::vector<float>& val) {
   }
 }
 
-void GraphNetwork::set_learning_rate(float src) {
-  if (src > 0) learning_rate_ = src;
+void GraphNetwork::set_sigmoid_mode(const s21_kernels::SigmoidMode& mode) {
+  sigmoid_mode_ = mode;
+}
+
+s21_kernels::SigmoidMode GraphNetwork::get_sigmoid_mode() const {
+  return sigmoid_mode_;
+}
+
+void GraphNetwork::set_optimizer(const OptimizerConfig& config) {
+  /*---пробное создание проверяет параметры, при ошибке сеть не меняется---*/
+  delete Optimizer<float>::Create(config);
+  optimizer_config_ = config;
+  ApplyOptimizer();
+}
+
+OptimizerConfig GraphNetwork::get_optimizer() const {
+  return optimizer_config_;
+}
+
+void GraphNetwork::ApplyOptimizer() {
+  for (auto& i : hidden_layer_)
+    for (auto j : i)
+      j->set_optimizer(Optimizer<float>::Create(optimizer_config_));
+  for (auto i : output_layer_)
+    i->set_optimizer(Optimizer<float>::Create(optimizer_config_));
+}
+
+void GraphNetwork::set_learning_rate(const double& learning_rate) {
+  if (learning_rate > 0) learning_rate_ = learning_rate;
+}
+
+double GraphNetwork::get_learning_rate() const { return learning_rate_; }
+
+InterfaceNetwork* GraphNetwork::Clone() const {
+  auto* copy = new GraphNetwork((int)hidden_layer_.size(), learning_rate_);
+  CopySettings(hidden_layer_.size(), copy);
+  return copy;
 }
 
 void GraphNetwork::EducateOneStep(const std::vector<float>& src,
@@ -163,7 +215,9 @@ void GraphNetwork::EducateOneStep(const std::vector<float>& src,
   CorrectWeights();
 }
 
-bool GraphNetwork::is_set_up() { return (input_layer_.size()) ? true : false; }
+bool GraphNetwork::is_set_up() const {
+  return (input_layer_.size()) ? true : false;
+}
 
 void GraphNetwork::Feed(const std::vector<float>& src) {
   for (size_t i{}; i < input_layer_.size(); i++) {
@@ -176,10 +230,117 @@ void GraphNetwork::Feed(const std::vector<float>& src) {
 }
 
 void GraphNetwork::Execute() {
-  for (auto& i : hidden_layer_) {
-    for (auto j : i) j->Activate();
+  for (auto& i : hidden_layer_) ActivateLayer(i);
+  ActivateLayer(output_layer_);
+}
+
+/*---сначала собираем суммы входов всего слоя, затем считаем активацию
+ * одним векторным вызовом, тем же, что и в матричной сети---*/
+void GraphNetwork::ActivateLayer(const std::vector<Neuron*>& layer) {
+  layer_sums_.resize(layer.size());
+  for (size_t i{}; i < layer.size(); i++)
+    layer_sums_[i] = layer[i]->SumInput();
+  ApplyActivation(layer, &layer_sums_);
+  for (size_t i{}; i < layer.size(); i++) layer[i]->set_value(layer_sums_[i]);
+}
+
+/*---выходной слой kSoftmax нормируется целиком, остальные слои - по
+ * режиму своих нейронов, у всех нейронов слоя он один---*/
+void GraphNetwork::ApplyActivation(const std::vector<Neuron*>& layer,
+                                   std::vector<float>* sums) const {
+  if (&layer == &output_layer_ && output_type_ == OutputType::kSoftmax)
+    s21_kernels::Softmax(sums->data(), sums->size(), sigmoid_mode_);
+  else if (!layer.empty() && layer.front()->get_mode() != ActFunction::kLinear)
+    s21_kernels::Activate(sums->data(), sums->size(),
+                          KernelActivation(layer.front()->get_mode()),
+                          sigmoid_mode_);
+}
+
+/*---сигналы слоев от входного до выходного, у каждого потока свои, и
+ * производные слоев от первого скрытого до выходного для обучения---*/
+class GraphNetwork::Workspace : public InferenceWorkspace {
+ public:
+  std::vector<std::vector<float>> values;
+  std::vector<std::vector<float>> derivs;
+};
+
+InferenceWorkspace* GraphNetwork::CreateWorkspace() const {
+  Workspace* workspace = new Workspace();
+  workspace->values.emplace_back(input_layer_.size());
+  for (auto& i : hidden_layer_) workspace->values.emplace_back(i.size());
+  workspace->values.emplace_back(output_layer_.size());
+  workspace->derivs.assign(workspace->values.begin() + 1,
+                           workspace->values.end());
+  return workspace;
+}
+
+GraphNetwork::Workspace* GraphNetwork::CheckWorkspace(
+    InferenceWorkspace* workspace) const {
+  if (!is_set_up()) throw std::out_of_range("network not set up");
+
+  Workspace* own = dynamic_cast<Workspace*>(workspace);
+  bool fits = own && own->values.size() == hidden_layer_.size() + 2 &&
+              own->values.front().size() == input_layer_.size() &&
+              own->values.back().size() == output_layer_.size();
+  for (size_t i{}; fits && i < hidden_layer_.size(); i++)
+    fits = own->values[i + 1].size() == hidden_layer_[i].size();
+  if (!fits)
+    throw std::invalid_argument("workspace wasn't created by this network");
+  return own;
+}
+
+int GraphNetwork::Execute(Workspace* workspace) const {
+  std::vector<std::vector<float>>& values = workspace->values;
+  for (size_t i{}; i < hidden_layer_.size(); i++)
+    ActivateLayer(hidden_layer_[i], values[i], &values[i + 1]);
+  ActivateLayer(output_layer_, values[hidden_layer_.size()], &values.back());
+
+  const std::vector<float>& output = values.back();
+  int res{};
+  for (size_t i{1}; i < output.size(); i++)
+    if (output[res] < output[i]) res = i;
+  return res;
+}
+
+/*---то же, что ActivateLayer выше, но сигналы берутся из inputs и пишутся
+ * в outputs, а не в нейроны---*/
+void GraphNetwork::ActivateLayer(const std::vector<Neuron*>& layer,
+                                 const std::vector<float>& inputs,
+                                 std::vector<float>* outputs) const {
+  for (size_t i{}; i < layer.size(); i++)
+    (*outputs)[i] = layer[i]->SumInput(inputs);
+  ApplyActivation(layer, outputs);
+}
+
+/*---то же, что CalcDerivOutput, CalcDerivHidden и CorrectWeights, но
+ * сигналы и производные берутся из workspace---*/
+void GraphNetwork::CorrectWeights(Workspace* workspace, int expectation) {
+  std::vector<std::vector<float>>& values = workspace->values;
+  std::vector<std::vector<float>>& derivs = workspace->derivs;
+  int depth = get_hid_depth();
+  for (int i{}; i < get_out_width(); i++) {
+    float value = values.back()[i];
+    float expected = i == expectation ? 1.0 : 0.0;
+    derivs.back()[i] = output_type_ == OutputType::kSoftmax
+                           ? value - expected
+                           : (value - expected) * value * (1 - value);
+  }
+  for (int i = depth - 1; i >= 0; i--) {
+    int width = get_num_neuron(i);
+    for (int j{}; j < width; j++) {
+      float sum{};
+      for (int k{}; k < get_num_neuron(i + 1); k++)
+        sum += derivs[i + 1][k] * weight(i + 1, k, j);
+      derivs[i][j] = sum;
+    }
+    s21_kernels::ActivationDerivative(values[i + 1].data(), derivs[i].data(),
+                                      width, get_activation(i));
+  }
+  for (int i{}; i < depth + 1; i++) {
+    for (int j{}; j < get_num_neuron(i); j++)
+      get_neuron(i, j)->CorrectWeights(values[i], derivs[i][j],
+                                       learning_rate_);
   }
-  for (auto i : output_layer_) i->Activate();
 }
 
 int GraphNetwork::get_result() {
@@ -224,6 +385,10 @@ void GraphNetwork::SaveWeights(const std::string& filename) {
     setlocale(LC_ALL, "en_US.UTF-8");
     stream << "Weights Network" << std::endl;
     stream << std::to_string(get_hid_depth()) + " Hiddens Layers" << std::endl;
+    std::vector<s21_kernels::Activation> activations{};
+    for (size_t i{}; i < hidden_layer_.size(); i++)
+      activations.push_back(get_activation(i));
+    WriteActivations(activations, &stream);
     for (size_t i{}; i < hidden_layer_.size() + 1; i++) {
       for (int k{}; k < get_num_inputs(i); k++) {
         for (int j{}; j < get_num_neuron(i); j++) {
@@ -239,6 +404,40 @@ void GraphNetwork::SaveWeights(const std::string& filename) {
   }
 }
 
+/*---тот же порядок, что в файле весов: вход за входом по всем нейронам
+ * слоя---*/
+std::vector<double> GraphNetwork::GetWeights() const {
+  std::vector<double> res{};
+  for (size_t i{}; i < hidden_layer_.size() + 1; i++) {
+    const std::vector<Neuron*>& layer =
+        i < hidden_layer_.size() ? hidden_layer_[i] : output_layer_;
+    size_t inputs = i ? hidden_layer_[i - 1].size() : input_layer_.size();
+    for (size_t k{}; k < inputs; k++)
+      for (auto j : layer) res.push_back(j->weight(k));
+  }
+  return res;
+}
+
+void GraphNetwork::SetWeights(const std::vector<double>& weights) {
+  size_t count{};
+  for (size_t i{}; i < hidden_layer_.size() + 1; i++) {
+    size_t neurons = i < hidden_layer_.size() ? hidden_layer_[i].size()
+                                              : output_layer_.size();
+    count += neurons * (i ? hidden_layer_[i - 1].size() : input_layer_.size());
+  }
+  if (weights.size() != count)
+    throw std::invalid_argument("weights count doesn't match network");
+
+  size_t index{};
+  for (size_t i{}; i < hidden_layer_.size() + 1; i++) {
+    const std::vector<Neuron*>& layer =
+        i < hidden_layer_.size() ? hidden_layer_[i] : output_layer_;
+    size_t inputs = i ? hidden_layer_[i - 1].size() : input_layer_.size();
+    for (size_t k{}; k < inputs; k++)
+      for (auto j : layer) j->weight(k) = weights[index++];
+  }
+}
+
 void GraphNetwork::LoadWeights(const std::string& filename) {
   std::ifstream stream(filename);
 
@@ -254,6 +453,10 @@ void GraphNetwork::LoadWeights(const std::string& filename) {
       std::getline(stream, type_network);
       if (type_network ==
           (std::to_string(get_hid_depth()) + " Hiddens Layers")) {
+        std::vector<s21_kernels::Activation> activations =
+            ReadActivations(&stream, hidden_layer_.size());
+        for (size_t i{}; i < activations.size(); i++)
+          set_activation(i, activations[i]);
         int index_layer{};
         while (!stream.eof()) {
           std::getline(stream, line);
@@ -296,12 +499,22 @@ void GraphNetwork::LoadWeights(const std::string& filename) {
   }
 }
 
-void GraphNetwork::InstallRandomWeights() {
-  srand(time(0));
+void GraphNetwork::InstallRandomWeights() { InstallRandomWeights(time(0)); }
+
+void GraphNetwork::InstallRandomWeights(const unsigned& seed) {
+  srand(seed);
   for (int i{}; i < get_hid_depth() + 1; i++) {
+    /*---у ReLU и tanh разброс сужается по числу входов, как в матричной
+     * сети---*/
+    int mode = get_neuron(i, 0)->get_mode();
+    double scale = 1;
+    if (mode == ActFunction::kRelu || mode == ActFunction::kLeakyRelu)
+      scale = std::sqrt(6.0 / get_num_inputs(i));
+    else if (mode == ActFunction::kTanh)
+      scale = std::sqrt(6.0 / (get_num_inputs(i) + get_num_neuron(i)));
     for (int j{}; j < get_num_neuron(i); j++) {
       for (int k{}; k < get_num_inputs(i); k++) {
-        weight(i, j, k) = Roll(201) / 100.0 - 1.0;
+        weight(i, j, k) = (Roll(201) / 100.0 - 1.0) * scale;
       }
     }
   }
@@ -311,11 +524,83 @@ size_t GraphNetwork::Prediction(const std::vector<unsigned>& input_values) {
   return (size_t)Run(FormFeedVector(input_values)) + 1;
 }
 
+/*---у графа нет матричной формы, изображения идут по одному, но без
+ * выделения памяти на каждое---*/
+void GraphNetwork::PredictBatch(const uint8_t* pixels, const size_t& n,
+                                size_t* out_labels) {
+  if (!is_set_up()) throw std::out_of_range("network not set up");
+
+  feed_values_.resize(kInputLayer);
+  for (size_t s{}; s < n; s++) {
+    const uint8_t* image = pixels + s * kInputLayer;
+    for (size_t i{}; i < kInputLayer; i++) feed_values_[i] = image[i] / 255.0;
+    Feed(feed_values_);
+    Execute();
+    out_labels[s] = (size_t)get_result() + 1;
+  }
+}
+
+size_t GraphNetwork::Prediction(const std::vector<unsigned>& input_values,
+                                InferenceWorkspace* workspace) const {
+  Workspace* own = CheckWorkspace(workspace);
+  std::vector<float>& feed = own->values.front();
+  for (size_t i{}; i < feed.size(); i++)
+    feed[i] = i < input_values.size() ? input_values[i] / 255.0 : 0;
+  return (size_t)Execute(own) + 1;
+}
+
+void GraphNetwork::PredictBatch(const uint8_t* pixels, const size_t& n,
+                                size_t* out_labels,
+                                InferenceWorkspace* workspace) const {
+  Workspace* own = CheckWorkspace(workspace);
+  std::vector<float>& feed = own->values.front();
+  for (size_t s{}; s < n; s++) {
+    const uint8_t* image = pixels + s * kInputLayer;
+    for (size_t i{}; i < feed.size(); i++)
+      feed[i] = i < kInputLayer ? image[i] / 255.0 : 0;
+    out_labels[s] = (size_t)Execute(own) + 1;
+  }
+}
+
 void GraphNetwork::LearnNetwork(const std::vector<unsigned>& input_values,
                                 const size_t& expected_value) {
   EducateOneStep(FormFeedVector(input_values), (int)(expected_value - 1));
 }
 
+void GraphNetwork::LearnNetwork(const std::vector<unsigned>& input_values,
+                                const size_t& expected_value,
+                                InferenceWorkspace* workspace) {
+  Workspace* own = CheckWorkspace(workspace);
+  if (optimizer_config_.type != OptimizerType::kSgd)
+    throw std::invalid_argument(
+        "learning with a workspace needs the plain SGD step");
+  std::vector<float>& feed = own->values.front();
+  for (size_t i{}; i < feed.size(); i++)
+    feed[i] = i < input_values.size() ? input_values[i] / 255.0 : 0;
+  Execute(own);
+  CorrectWeights(own, (int)(expected_value - 1));
+}
+
+void GraphNetwork::PredictProbabilities(
+    const std::vector<unsigned>& input_values,
+    std::vector<double>* probabilities) {
+  Run(FormFeedVector(input_values));
+  probabilities->clear();
+  double sum{};
+  for (auto i : output_layer_) {
+    probabilities->push_back(i->get_value());
+    sum += i->get_value();
+  }
+  if (output_type_ == OutputType::kSigmoid)
+    for (auto& i : *probabilities) i /= sum;
+}
+
+void GraphNetwork::set_output_type(const OutputType& type) {
+  output_type_ = type;
+}
+
+OutputType GraphNetwork::get_output_type() const { return output_type_; }
+
 // random number generation
 int Roll(int base) {
   int res{};
@@ -362,22 +647,33 @@ int GraphNetwork::get_num_inputs(int layer) {
 void GraphNetwork::CalcDerivOutput() {
   for (int i{}; i < get_out_width(); i++) {
     float value = output_layer_[i]->get_value();
-    float deriv = (value - expected_values_[i]) * value * (1 - value);
+    /*---у softmax с перекрестной энтропией производная по сумме входов
+     * нейрона - просто разность---*/
+    float deriv = output_type_ == OutputType::kSoftmax
+                      ? value - expected_values_[i]
+                      : (value - expected_values_[i]) * value * (1 - value);
     output_layer_[i]->set_deriv(deriv);
   }
 }
 
+/*---ошибки нейронов слоя собираются в layer_sums_, затем производная
+ * активации умножается на них одним векторным вызовом---*/
 void GraphNetwork::CalcDerivHidden() {
   for (int i = get_hid_depth() - 1; i >= 0; i--) {
-    for (int j{}; j < get_num_neuron(i); j++) {
+    int width = get_num_neuron(i);
+    layer_sums_.resize(width);
+    layer_values_.resize(width);
+    for (int j{}; j < width; j++) {
       float sum{};
       for (int k{}; k < get_num_neuron(i + 1); k++) {
         sum += get_neuron(i + 1, k)->get_deriv() * weight(i + 1, k, j);
       }
-      float value = get_neuron(i, j)->get_value();
-      float deriv = sum * value * (1 - value);
-      get_neuron(i, j)->set_deriv(deriv);
+      layer_sums_[j] = sum;
+      layer_values_[j] = get_neuron(i, j)->get_value();
     }
+    s21_kernels::ActivationDerivative(layer_values_.data(), layer_sums_.data(),
+                                      width, get_activation(i));
+    for (int j{}; j < width; j++) get_neuron(i, j)->set_deriv(layer_sums_[j]);
   }
 }
 
@@ -11,6 +11,12 @@ class GraphNetwork : public InterfaceNetwork {
   std::vector<Neuron*> output_layer_{};
   std::vector<float> expected_values_{};
   float learning_rate_ = 0.2;
+  OptimizerConfig optimizer_config_{};
+  OutputType output_type_ = OutputType::kSigmoid;
+  s21_kernels::SigmoidMode sigmoid_mode_ = s21_kernels::SigmoidMode::kPrecise;
+  std::vector<float> layer_sums_{};  // суммы входов активируемого слоя
+  std::vector<float> layer_values_{};  // сигналы слоя для производной
+  std::vector<float> feed_values_{};  // вход очередного изображения пакета
 
  public:
   GraphNetwork() {}
@@ -36,14 +42,53 @@ class GraphNetwork : public InterfaceNetwork {
   void SaveWeights(const std::string& filename) override;
   void LoadWeights(const std::string& filename) override;
   void InstallRandomWeights() override;
+  void InstallRandomWeights(const unsigned& seed) override;
+  std::vector<double> GetWeights() const override;
+  void SetWeights(const std::vector<double>& weights) override;
   size_t Prediction(const std::vector<unsigned> &input_values) override;
+  void PredictBatch(const uint8_t *pixels, const size_t &n,
+                    size_t *out_labels) override;
+  InferenceWorkspace *CreateWorkspace() const override;
+  size_t Prediction(const std::vector<unsigned> &input_values,
+                    InferenceWorkspace *workspace) const override;
+  void PredictBatch(const uint8_t *pixels, const size_t &n,
+                    size_t *out_labels,
+                    InferenceWorkspace *workspace) const override;
   void LearnNetwork(const std::vector<unsigned> &input_values,
         const size_t &expected_value) override;
+  void LearnNetwork(const std::vector<unsigned> &input_values,
+                    const size_t &expected_value,
+                    InferenceWorkspace *workspace) override;
+  void PredictProbabilities(const std::vector<unsigned> &input_values,
+                            std::vector<double> *probabilities) override;
+  void set_output_type(const OutputType &type) override;
+  OutputType get_output_type() const override;
+  void set_activation(const size_t &layer,
+                      const s21_kernels::Activation &activation) override;
+  s21_kernels::Activation get_activation(const size_t &layer) const override;
 
   void set_expected_values(const std::vector<float>& val);
-  void set_learning_rate(float src);
+  void set_sigmoid_mode(const s21_kernels::SigmoidMode& mode) override;
+  s21_kernels::SigmoidMode get_sigmoid_mode() const override;
+  void set_optimizer(const OptimizerConfig& config) override;
+  OptimizerConfig get_optimizer() const override;
+  void set_learning_rate(const double& learning_rate) override;
+  double get_learning_rate() const override;
+  InterfaceNetwork* Clone() const override;
 
  private:
+  class Workspace;
+  Workspace* CheckWorkspace(InferenceWorkspace* workspace) const;
+  /*---прямой проход по входу workspace без изменения нейронов, возвращает
+   * номер нейрона ответа---*/
+  int Execute(Workspace* workspace) const;
+  /*---производные и шаг весов по сигналам workspace, производные тоже
+   * пишутся в нее---*/
+  void CorrectWeights(Workspace* workspace, int expectation);
+  void ActivateLayer(const std::vector<Neuron*>& layer,
+                     const std::vector<float>& inputs,
+                     std::vector<float>* outputs) const;
+
   void CreateInputLayer(int num);
   void CreateHiddenLayer(int num, int size);
   void CreateOutputLayer(int num);
@@ -56,14 +101,21 @@ class GraphNetwork : public InterfaceNetwork {
   void ConnectInputHidden();
   void ConnectHiddenOutput();
 
+  /*---дает каждому нейрону с входами свой оптимизатор по optimizer_config_,
+   * нужно после каждого пересоздания нейронов---*/
+  void ApplyOptimizer();
+
   void SeparateInputHidden();
   void SeparateHiddenOutput();
 
-  bool is_set_up();
+  bool is_set_up() const;
   int Run(const std::vector<float>& src);
   void EducateOneStep(const std::vector<float>& src, int expectation);
   void Feed(const std::vector<float>& src);
   void Execute();
+  void ActivateLayer(const std::vector<Neuron*>& layer);
+  void ApplyActivation(const std::vector<Neuron*>& layer,
+                       std::vector<float>* sums) const;
   int get_result();
 
   void CalcDerivOutput();
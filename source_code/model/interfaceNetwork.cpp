@@ -0,0 +1,71 @@
+#include "interfaceNetwork.hpp"
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace s21_network {
+
+void WriteActivations(
+    const std::vector<s21_kernels::Activation> &activations,
+    std::ostream *stream) {
+  if (std::all_of(activations.begin(), activations.end(),
+                  [](const s21_kernels::Activation &activation) {
+                    return activation == s21_kernels::Activation::kSigmoid;
+                  })) {
+    return;
+  }
+  *stream << "Activations";
+  for (auto activation : activations) {
+    *stream << " " << s21_kernels::ActivationName(activation);
+  }
+  *stream << std::endl;
+}
+
+std::vector<s21_kernels::Activation> ReadActivations(
+    std::istream *stream, const size_t &sum_hidden_layers) {
+  std::vector<s21_kernels::Activation> activations(
+      sum_hidden_layers, s21_kernels::Activation::kSigmoid);
+  std::streampos start = stream->tellg();
+  std::string line{};
+  std::getline(*stream, line);
+  std::istringstream words(line);
+  std::string word{};
+  words >> word;
+  if (word != "Activations") {
+    /*---это уже веса первого слоя---*/
+    stream->clear();
+    stream->seekg(start);
+    return activations;
+  }
+
+  for (auto &activation : activations) {
+    if (!(words >> word) ||
+        !s21_kernels::ParseActivation(word.c_str(), &activation)) {
+      throw std::invalid_argument(
+          "Error, wrong activations in the weights file: " + line);
+    }
+  }
+  if (words >> word) {
+    throw std::invalid_argument(
+        "Error, more activations than hidden layers in the weights file: " +
+        line);
+  }
+  return activations;
+}
+
+void InterfaceNetwork::CopySettings(const size_t &sum_hidden_layers,
+                                    InterfaceNetwork *copy) const {
+  copy->set_output_type(get_output_type());
+  for (size_t layer = 0; layer < sum_hidden_layers; ++layer) {
+    copy->set_activation(layer, get_activation(layer));
+  }
+  copy->set_sigmoid_mode(get_sigmoid_mode());
+  copy->set_optimizer(get_optimizer());
+  copy->set_learning_rate(get_learning_rate());
+  copy->SetWeights(GetWeights());
+}
+
+}  // namespace s21_network
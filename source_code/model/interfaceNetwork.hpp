@@ -1,21 +1,130 @@
 #pragma once
 
+#include <cstdint>
+#include <iosfwd>
 #include <string>
 #include <vector>
 
+#include "matrixKernels.hpp"
+#include "optimizer.hpp"
+
 namespace s21_network {
 
 constexpr unsigned kInputLayer = 784;
 constexpr unsigned kSumNeironsHiddenLayer = 140;
 constexpr unsigned kSumNeironsOutputLayer = 26;
 
+/*---выходной слой и функция ошибки обучения:
+ *   kSigmoid - сигмоиды и квадратичная ошибка
+ *   kSoftmax - softmax и перекрестная энтропия, дельта выхода - просто
+ *              target - output, без множителя s * (1 - s), который гасит
+ *              градиент у насыщенных нейронов---*/
+enum class OutputType { kSigmoid, kSoftmax };
+
+/*---строка "Activations relu tanh ..." файла весов, сразу после числа
+ * скрытых слоев: функции активации скрытых слоев по порядку. Ее пишут
+ * только сети, где не все скрытые слои сигмоидные, поэтому файлы обычных
+ * сетей не меняются; без нее все слои сигмоидные. ReadActivations
+ * оставляет поток на месте, если строки нет, и бросает
+ * std::invalid_argument, если строка не подходит сети---*/
+void WriteActivations(
+    const std::vector<s21_kernels::Activation> &activations,
+    std::ostream *stream);
+std::vector<s21_kernels::Activation> ReadActivations(
+    std::istream *stream, const size_t &sum_hidden_layers);
+
+/*---рабочая память распознавания и обучения, которой владеет вызывающий.
+ * У каждого потока своя, тогда одну сеть с одними весами можно опрашивать
+ * из многих потоков сразу, без блокировок и без копий весов---*/
+class InferenceWorkspace {
+ public:
+  virtual ~InferenceWorkspace() {}
+};
+
 class InterfaceNetwork {
  public:
+  virtual ~InterfaceNetwork() {}
+
   void virtual InstallRandomWeights() = 0;
+  /*---случайные веса из seed вместо времени: при одном seed одни и те
+   * же---*/
+  void virtual InstallRandomWeights(const unsigned &seed) = 0;
   void virtual LoadWeights(const std::string &filename) = 0;
   void virtual SaveWeights(const std::string &filename) = 0;
+  /*---все веса одним вектором, слой за слоем в порядке файла весов (строка -
+   * вход, столбец - нейрон); SetWeights принимает вектор той же длины, иначе
+   * std::invalid_argument---*/
+  std::vector<double> virtual GetWeights() const = 0;
+  void virtual SetWeights(const std::vector<double> &weights) = 0;
   size_t virtual Prediction(const std::vector<unsigned> &input_layer) = 0;
+  /*---распознает n изображений за один вызов: pixels - n строк подряд по
+   * kInputLayer яркостей 0..255, ответы (с единицы) пишутся в
+   * out_labels[0..n)---*/
+  void virtual PredictBatch(const uint8_t *pixels, const size_t &n,
+                            size_t *out_labels) = 0;
+
+  /*---рабочая память под эту сеть, удаляет ее вызывающий---*/
+  InferenceWorkspace virtual *CreateWorkspace() const = 0;
+  /*---то же распознавание без изменения сети: все промежуточные сигналы
+   * пишутся в workspace, созданную CreateWorkspace этой сети, иначе
+   * std::invalid_argument. Пока веса не меняются, вызовы из разных потоков
+   * с разными workspace независимы---*/
+  size_t virtual Prediction(const std::vector<unsigned> &input_layer,
+                            InferenceWorkspace *workspace) const = 0;
+  void virtual PredictBatch(const uint8_t *pixels, const size_t &n,
+                            size_t *out_labels,
+                            InferenceWorkspace *workspace) const = 0;
   void virtual LearnNetwork(const std::vector<unsigned> &input_layer,
                             const size_t &expected_value) = 0;
+  /*---тот же шаг обучения, но сигналы и дельты слоев пишутся в workspace,
+   * в сети меняются только веса. Вызовы из разных потоков с разными
+   * workspace правят общие веса без блокировок (Hogwild) и изредка
+   * затирают шаги друг друга, на почти нулевых входах это редко. Только
+   * для простого шага kSgd, у других оптимизаторов состояние общее, иначе
+   * std::invalid_argument---*/
+  void virtual LearnNetwork(const std::vector<unsigned> &input_layer,
+                            const size_t &expected_value,
+                            InferenceWorkspace *workspace) = 0;
+  /*---вероятности ответов (индекс - ответ минус один), в сумме 1; у выхода
+   * kSigmoid это сигналы выходного слоя, нормированные на их сумму---*/
+  void virtual PredictProbabilities(const std::vector<unsigned> &input_layer,
+                                    std::vector<double> *probabilities) = 0;
+
+  /*---веса при смене типа выхода не меняются, ответ сети тоже: обе функции
+   * монотонны---*/
+  void virtual set_output_type(const OutputType &type) = 0;
+  OutputType virtual get_output_type() const = 0;
+
+  /*---функция активации скрытого слоя layer (с нуля), ее запоминает файл
+   * весов; у выходного слоя ее задает set_output_type. std::out_of_range
+   * для слоя вне сети---*/
+  void virtual set_activation(const size_t &layer,
+                              const s21_kernels::Activation &activation) = 0;
+  s21_kernels::Activation virtual get_activation(
+      const size_t &layer) const = 0;
+
+  /*---точность сигмоиды задается для каждой сети отдельно---*/
+  void virtual set_sigmoid_mode(const s21_kernels::SigmoidMode &mode) = 0;
+  s21_kernels::SigmoidMode virtual get_sigmoid_mode() const = 0;
+
+  /*---оптимизатор шага обучения, смена сбрасывает его состояние;
+   * std::invalid_argument при неверных параметрах---*/
+  void virtual set_optimizer(const OptimizerConfig &config) = 0;
+  OptimizerConfig virtual get_optimizer() const = 0;
+  /*---у разных оптимизаторов хороший шаг разный, поэтому он задается
+   * отдельно, значение <= 0 игнорируется---*/
+  void virtual set_learning_rate(const double &learning_rate) = 0;
+  double virtual get_learning_rate() const = 0;
+
+  /*---новая сеть того же вида и топологии с теми же весами и настройками,
+   * состояние оптимизатора у нее свое, с нуля; удаляет ее вызывающий---*/
+  InterfaceNetwork virtual *Clone() const = 0;
+
+ protected:
+  /*---для Clone: переносит в copy с тем же числом скрытых слоев тип
+   * выхода, функции активации, режим сигмоиды, оптимизатор, шаг и
+   * веса---*/
+  void CopySettings(const size_t &sum_hidden_layers,
+                    InterfaceNetwork *copy) const;
 };
 }  // namespace s21_network
@@ -0,0 +1,813 @@
+#include "matrixKernels.hpp"
+
+#include "computeBackend.hpp"
+#include "threadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+/*---S21_KERNELS_NO_SIMD оставляет только переносимые ядра---*/
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    !defined(S21_KERNELS_NO_SIMD)
+#define S21_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace s21_kernels {
+
+namespace {
+
+/*---exp(x) = 2^n * exp(r), x = n * ln2 + r, |r| <= ln2 / 2, exp(r) считается
+ * отрезком ряда Тейлора. ln2 разбит на две части, старшая содержит мало
+ * значащих бит, поэтому n * kLn2Hi вычисляется без округления---*/
+template <class T>
+struct ExpConstants;
+
+template <>
+struct ExpConstants<double> {
+  static constexpr double kLimit = 708;
+  static constexpr double kLog2e = 1.4426950408889634;
+  static constexpr double kLn2Hi = 6.93147180369123816490e-01;
+  static constexpr double kLn2Lo = 1.90821492927058770002e-10;
+  /*---1.5 * 2^52: в сумме с ним младшие биты мантиссы хранят n---*/
+  static constexpr double kShifter = 6755399441055744.0;
+  static constexpr int kPreciseDegree = 12;
+  static constexpr int kFastDegree = 4;
+};
+
+template <>
+struct ExpConstants<float> {
+  static constexpr float kLimit = 87;
+  static constexpr float kLog2e = 1.44269504f;
+  static constexpr float kLn2Hi = 0.693359375f;
+  static constexpr float kLn2Lo = -2.12194440e-4f;
+  /*---1.5 * 2^23---*/
+  static constexpr float kShifter = 12582912.0f;
+  static constexpr int kPreciseDegree = 7;
+  static constexpr int kFastDegree = 4;
+};
+
+/*---коэффициенты ряда Тейлора exp: 1 / d!---*/
+constexpr double kInvFactorial[] = {1.0,
+                                    1.0,
+                                    1.0 / 2,
+                                    1.0 / 6,
+                                    1.0 / 24,
+                                    1.0 / 120,
+                                    1.0 / 720,
+                                    1.0 / 5040,
+                                    1.0 / 40320,
+                                    1.0 / 362880,
+                                    1.0 / 3628800,
+                                    1.0 / 39916800,
+                                    1.0 / 479001600};
+
+/*---размеры блоков gemm: панель A (kGemmMc x kGemmKc) остается в L2, полоса
+ * B шириной в два регистра - в L1---*/
+constexpr int kGemmKc = 256;
+constexpr int kGemmMc = 96;
+constexpr int kGemmNc = 1024;
+/*---ширина панели столбцов при делении gemm между потоками кратна ей, она
+ * кратна ширине тайла микроядра любого набора инструкций---*/
+constexpr int kGemmPanelColumns = 64;
+/*---меньше стольких умножений на задачу gemm не делится: запуск задач
+ * дороже выигрыша---*/
+constexpr double kGemmMinWorkPerTask = 1 << 18;
+
+/*––––––––––– portable kernels, used when the cpu has no avx2 ––––––––––––*/
+
+namespace scalar {
+
+#define S21_SIMD_TARGET
+
+/*---"регистр" из четырех чисел, компилятор сам переводит циклы по нему в
+ * инструкции sse2/neon---*/
+template <class T>
+struct Simd {
+  static constexpr int kWidth = 4;
+  static constexpr int kGemmRows = 4;
+  struct reg {
+    T v[kWidth];
+  };
+  static reg zero() { return set1(0); }
+  static reg set1(T a) {
+    reg r;
+    for (int i = 0; i < kWidth; ++i) r.v[i] = a;
+    return r;
+  }
+  static reg load(const T *p) {
+    reg r;
+    for (int i = 0; i < kWidth; ++i) r.v[i] = p[i];
+    return r;
+  }
+  static void store(T *p, const reg &a) {
+    for (int i = 0; i < kWidth; ++i) p[i] = a.v[i];
+  }
+  static reg add(const reg &a, const reg &b) {
+    reg r;
+    for (int i = 0; i < kWidth; ++i) r.v[i] = a.v[i] + b.v[i];
+    return r;
+  }
+  static reg sub(const reg &a, const reg &b) {
+    reg r;
+    for (int i = 0; i < kWidth; ++i) r.v[i] = a.v[i] - b.v[i];
+    return r;
+  }
+  static reg mul(const reg &a, const reg &b) {
+    reg r;
+    for (int i = 0; i < kWidth; ++i) r.v[i] = a.v[i] * b.v[i];
+    return r;
+  }
+  static reg div(const reg &a, const reg &b) {
+    reg r;
+    for (int i = 0; i < kWidth; ++i) r.v[i] = a.v[i] / b.v[i];
+    return r;
+  }
+  static reg sqrt(const reg &a) {
+    reg r;
+    for (int i = 0; i < kWidth; ++i) r.v[i] = std::sqrt(a.v[i]);
+    return r;
+  }
+  static reg min(const reg &a, const reg &b) {
+    reg r;
+    for (int i = 0; i < kWidth; ++i) r.v[i] = std::min(a.v[i], b.v[i]);
+    return r;
+  }
+  static reg max(const reg &a, const reg &b) {
+    reg r;
+    for (int i = 0; i < kWidth; ++i) r.v[i] = std::max(a.v[i], b.v[i]);
+    return r;
+  }
+  static reg fmadd(const reg &a, const reg &b, const reg &c) {
+    reg r;
+    for (int i = 0; i < kWidth; ++i) r.v[i] = a.v[i] * b.v[i] + c.v[i];
+    return r;
+  }
+  /*---x > 0 ? a : b поэлементно---*/
+  static reg select_positive(const reg &x, const reg &a, const reg &b) {
+    reg r;
+    for (int i = 0; i < kWidth; ++i) r.v[i] = x.v[i] > 0 ? a.v[i] : b.v[i];
+    return r;
+  }
+  /*---2^n по числу shifted = n + ExpConstants<T>::kShifter: n прибавляется к
+   * смещению порядка и сдвигается в поле порядка---*/
+  static reg pow2(const reg &shifted) {
+    using Bits = typename std::conditional<sizeof(T) == 8, std::uint64_t,
+                                           std::uint32_t>::type;
+    constexpr int kMantissa = sizeof(T) == 8 ? 52 : 23;
+    constexpr Bits kBias = sizeof(T) == 8 ? 1023 : 127;
+    reg r;
+    for (int i = 0; i < kWidth; ++i) {
+      Bits bits;
+      std::memcpy(&bits, &shifted.v[i], sizeof(bits));
+      bits = (bits + kBias) << kMantissa;
+      std::memcpy(&r.v[i], &bits, sizeof(bits));
+    }
+    return r;
+  }
+};
+
+#include "matrixKernelsSimd.inc"
+
+#undef S21_SIMD_TARGET
+
+}  // namespace scalar
+
+#ifdef S21_KERNELS_X86
+
+/*––––––––––– avx2 + fma –––––––––––––––––––––––––––––––––––––––––––––––––––*/
+
+namespace avx2 {
+
+#define S21_SIMD_TARGET __attribute__((target("avx2,fma")))
+
+template <class T>
+struct Simd;
+
+template <>
+struct Simd<double> {
+  using reg = __m256d;
+  static constexpr int kWidth = 4;
+  static constexpr int kGemmRows = 4;
+  S21_SIMD_TARGET static reg zero() { return _mm256_setzero_pd(); }
+  S21_SIMD_TARGET static reg set1(double a) { return _mm256_set1_pd(a); }
+  S21_SIMD_TARGET static reg load(const double *p) {
+    return _mm256_loadu_pd(p);
+  }
+  S21_SIMD_TARGET static void store(double *p, reg a) {
+    _mm256_storeu_pd(p, a);
+  }
+  S21_SIMD_TARGET static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+  S21_SIMD_TARGET static reg sub(reg a, reg b) { return _mm256_sub_pd(a, b); }
+  S21_SIMD_TARGET static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+  S21_SIMD_TARGET static reg div(reg a, reg b) { return _mm256_div_pd(a, b); }
+  S21_SIMD_TARGET static reg sqrt(reg a) { return _mm256_sqrt_pd(a); }
+  S21_SIMD_TARGET static reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+  S21_SIMD_TARGET static reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+  S21_SIMD_TARGET static reg fmadd(reg a, reg b, reg c) {
+    return _mm256_fmadd_pd(a, b, c);
+  }
+  S21_SIMD_TARGET static reg select_positive(reg x, reg a, reg b) {
+    return _mm256_blendv_pd(b, a, _mm256_cmp_pd(x, zero(), _CMP_GT_OQ));
+  }
+  S21_SIMD_TARGET static reg pow2(reg shifted) {
+    __m256i bits = _mm256_add_epi64(_mm256_castpd_si256(shifted),
+                                    _mm256_set1_epi64x(1023));
+    return _mm256_castsi256_pd(_mm256_slli_epi64(bits, 52));
+  }
+};
+
+template <>
+struct Simd<float> {
+  using reg = __m256;
+  static constexpr int kWidth = 8;
+  static constexpr int kGemmRows = 4;
+  S21_SIMD_TARGET static reg zero() { return _mm256_setzero_ps(); }
+  S21_SIMD_TARGET static reg set1(float a) { return _mm256_set1_ps(a); }
+  S21_SIMD_TARGET static reg load(const float *p) {
+    return _mm256_loadu_ps(p);
+  }
+  S21_SIMD_TARGET static void store(float *p, reg a) {
+    _mm256_storeu_ps(p, a);
+  }
+  S21_SIMD_TARGET static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+  S21_SIMD_TARGET static reg sub(reg a, reg b) { return _mm256_sub_ps(a, b); }
+  S21_SIMD_TARGET static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+  S21_SIMD_TARGET static reg div(reg a, reg b) { return _mm256_div_ps(a, b); }
+  S21_SIMD_TARGET static reg sqrt(reg a) { return _mm256_sqrt_ps(a); }
+  S21_SIMD_TARGET static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+  S21_SIMD_TARGET static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+  S21_SIMD_TARGET static reg fmadd(reg a, reg b, reg c) {
+    return _mm256_fmadd_ps(a, b, c);
+  }
+  S21_SIMD_TARGET static reg select_positive(reg x, reg a, reg b) {
+    return _mm256_blendv_ps(b, a, _mm256_cmp_ps(x, zero(), _CMP_GT_OQ));
+  }
+  S21_SIMD_TARGET static reg pow2(reg shifted) {
+    __m256i bits = _mm256_add_epi32(_mm256_castps_si256(shifted),
+                                    _mm256_set1_epi32(127));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(bits, 23));
+  }
+};
+
+#include "matrixKernelsSimd.inc"
+
+#undef S21_SIMD_TARGET
+
+}  // namespace avx2
+
+/*––––––––––– avx-512 ––––––––––––––––––––––––––––––––––––––––––––––––––––––*/
+
+/*---заголовки gcc 12 реализуют _mm512_undefined_* через самоинициализацию,
+ * и каждая встроенная min/max/slli дает ложное -Wmaybe-uninitialized---*/
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+namespace avx512 {
+
+#define S21_SIMD_TARGET __attribute__((target("avx512f,avx2,fma")))
+
+template <class T>
+struct Simd;
+
+template <>
+struct Simd<double> {
+  using reg = __m512d;
+  static constexpr int kWidth = 8;
+  static constexpr int kGemmRows = 8;
+  S21_SIMD_TARGET static reg zero() { return _mm512_setzero_pd(); }
+  S21_SIMD_TARGET static reg set1(double a) { return _mm512_set1_pd(a); }
+  S21_SIMD_TARGET static reg load(const double *p) {
+    return _mm512_loadu_pd(p);
+  }
+  S21_SIMD_TARGET static void store(double *p, reg a) {
+    _mm512_storeu_pd(p, a);
+  }
+  S21_SIMD_TARGET static reg add(reg a, reg b) { return _mm512_add_pd(a, b); }
+  S21_SIMD_TARGET static reg sub(reg a, reg b) { return _mm512_sub_pd(a, b); }
+  S21_SIMD_TARGET static reg mul(reg a, reg b) { return _mm512_mul_pd(a, b); }
+  S21_SIMD_TARGET static reg div(reg a, reg b) { return _mm512_div_pd(a, b); }
+  S21_SIMD_TARGET static reg sqrt(reg a) { return _mm512_sqrt_pd(a); }
+  S21_SIMD_TARGET static reg min(reg a, reg b) { return _mm512_min_pd(a, b); }
+  S21_SIMD_TARGET static reg max(reg a, reg b) { return _mm512_max_pd(a, b); }
+  S21_SIMD_TARGET static reg fmadd(reg a, reg b, reg c) {
+    return _mm512_fmadd_pd(a, b, c);
+  }
+  S21_SIMD_TARGET static reg select_positive(reg x, reg a, reg b) {
+    return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(x, zero(), _CMP_GT_OQ), b,
+                                a);
+  }
+  S21_SIMD_TARGET static reg pow2(reg shifted) {
+    __m512i bits = _mm512_add_epi64(_mm512_castpd_si512(shifted),
+                                    _mm512_set1_epi64(1023));
+    return _mm512_castsi512_pd(_mm512_slli_epi64(bits, 52));
+  }
+};
+
+template <>
+struct Simd<float> {
+  using reg = __m512;
+  static constexpr int kWidth = 16;
+  static constexpr int kGemmRows = 8;
+  S21_SIMD_TARGET static reg zero() { return _mm512_setzero_ps(); }
+  S21_SIMD_TARGET static reg set1(float a) { return _mm512_set1_ps(a); }
+  S21_SIMD_TARGET static reg load(const float *p) {
+    return _mm512_loadu_ps(p);
+  }
+  S21_SIMD_TARGET static void store(float *p, reg a) {
+    _mm512_storeu_ps(p, a);
+  }
+  S21_SIMD_TARGET static reg add(reg a, reg b) { return _mm512_add_ps(a, b); }
+  S21_SIMD_TARGET static reg sub(reg a, reg b) { return _mm512_sub_ps(a, b); }
+  S21_SIMD_TARGET static reg mul(reg a, reg b) { return _mm512_mul_ps(a, b); }
+  S21_SIMD_TARGET static reg div(reg a, reg b) { return _mm512_div_ps(a, b); }
+  S21_SIMD_TARGET static reg sqrt(reg a) { return _mm512_sqrt_ps(a); }
+  S21_SIMD_TARGET static reg min(reg a, reg b) { return _mm512_min_ps(a, b); }
+  S21_SIMD_TARGET static reg max(reg a, reg b) { return _mm512_max_ps(a, b); }
+  S21_SIMD_TARGET static reg fmadd(reg a, reg b, reg c) {
+    return _mm512_fmadd_ps(a, b, c);
+  }
+  S21_SIMD_TARGET static reg select_positive(reg x, reg a, reg b) {
+    return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(x, zero(), _CMP_GT_OQ), b,
+                                a);
+  }
+  S21_SIMD_TARGET static reg pow2(reg shifted) {
+    __m512i bits = _mm512_add_epi32(_mm512_castps_si512(shifted),
+                                    _mm512_set1_epi32(127));
+    return _mm512_castsi512_ps(_mm512_slli_epi32(bits, 23));
+  }
+};
+
+#include "matrixKernelsSimd.inc"
+
+#undef S21_SIMD_TARGET
+
+}  // namespace avx512
+
+#pragma GCC diagnostic pop
+
+#endif  // S21_KERNELS_X86
+
+/*––––––––––– dispatch –––––––––––––––––––––––––––––––––––––––––––––––––––––*/
+
+template <class T>
+struct KernelTable {
+  SimdLevel level;
+  void (*gemv)(const T *, const T *, int, int, int, T *, const T *,
+               SigmoidMode);
+  void (*gemv_sigmoid)(const T *, const T *, int, int, int, T *, const T *,
+                       SigmoidMode);
+  void (*gemv_sparse)(const T *, const int *, int, const T *, int, int, T *,
+                      const T *, SigmoidMode);
+  void (*gemv_sparse_sigmoid)(const T *, const int *, int, const T *, int,
+                              int, T *, const T *, SigmoidMode);
+  void (*gemv_transposed)(const T *, const T *, int, int, int, T *);
+  void (*gemm)(int, int, int, T, const Operand<T> &, const Operand<T> &, T,
+               T *, int);
+  void (*ger)(int, int, T, const T *, const T *, T *, int);
+  void (*sigmoid)(T *, int, SigmoidMode);
+  void (*softmax)(T *, int, SigmoidMode);
+  void (*activate)(T *, int, Activation, SigmoidMode);
+  void (*activation_derivative)(const T *, T *, int, Activation);
+  void (*momentum_step)(T *, const T *, T *, int, T, T, bool);
+  void (*adam_step)(T *, const T *, T *, T *, int, T, T, T, T);
+};
+
+template <class T>
+KernelTable<T> SelectKernels(const SimdLevel &level) {
+  switch (level) {
+#ifdef S21_KERNELS_X86
+    case SimdLevel::kAvx512:
+      return {level,
+              avx512::Gemv<false, T>,
+              avx512::Gemv<true, T>,
+              avx512::GemvSparse<false, T>,
+              avx512::GemvSparse<true, T>,
+              avx512::GemvTransposed<T>,
+              avx512::Gemm<T>,
+              avx512::Ger<T>,
+              avx512::Sigmoid<T>,
+              avx512::Softmax<T>,
+              avx512::Activate<T>,
+              avx512::ActivationDerivative<T>,
+              avx512::MomentumStep<T>,
+              avx512::AdamStep<T>};
+    case SimdLevel::kAvx2:
+      return {level,
+              avx2::Gemv<false, T>,
+              avx2::Gemv<true, T>,
+              avx2::GemvSparse<false, T>,
+              avx2::GemvSparse<true, T>,
+              avx2::GemvTransposed<T>,
+              avx2::Gemm<T>,
+              avx2::Ger<T>,
+              avx2::Sigmoid<T>,
+              avx2::Softmax<T>,
+              avx2::Activate<T>,
+              avx2::ActivationDerivative<T>,
+              avx2::MomentumStep<T>,
+              avx2::AdamStep<T>};
+#endif
+    default:
+      return {SimdLevel::kScalar,
+              scalar::Gemv<false, T>,
+              scalar::Gemv<true, T>,
+              scalar::GemvSparse<false, T>,
+              scalar::GemvSparse<true, T>,
+              scalar::GemvTransposed<T>,
+              scalar::Gemm<T>,
+              scalar::Ger<T>,
+              scalar::Sigmoid<T>,
+              scalar::Softmax<T>,
+              scalar::Activate<T>,
+              scalar::ActivationDerivative<T>,
+              scalar::MomentumStep<T>,
+              scalar::AdamStep<T>};
+  }
+}
+
+/*---таблица заполняется один раз, при первом обращении к ядрам---*/
+template <class T>
+const KernelTable<T> &Kernels() {
+  static const KernelTable<T> table = SelectKernels<T>(DetectSimdLevel());
+  return table;
+}
+
+/*---C делится на панели строк по kGemmMc, а если строк мало - на панели
+ * столбцов по kGemmPanelColumns, каждая панель - задача пула. Границы
+ * панелей лежат на сетке блоков и тайлов однопоточного произведения,
+ * поэтому каждый элемент C считается в том же порядке и результат не
+ * зависит от числа потоков. Панели считает бэкенд вызывающего потока: в
+ * потоках пула выбран свой---*/
+template <class T>
+void GemmOnPool(int m, int n, int k, T alpha, const Operand<T> &a,
+                const Operand<T> &b, T beta, T *c, int ldc,
+                s21_network::ThreadPool *pool) {
+  const ComputeBackend<T> &backend = ActiveBackend<T>();
+  size_t tasks = 1;
+  if (pool != nullptr) {
+    double work = (double)m * n * k;
+    tasks = std::min<double>(pool->get_threads(),
+                             std::max(1.0, work / kGemmMinWorkPerTask));
+  }
+  bool split_rows = m >= n && m > kGemmMc;
+  int unit = split_rows ? kGemmMc : kGemmPanelColumns;
+  int extent = split_rows ? m : n;
+  int panel = ((extent + tasks - 1) / tasks + unit - 1) / unit * unit;
+  if (tasks <= 1 || panel >= extent) {
+    backend.Gemm(m, n, k, alpha, a, b, beta, c, ldc);
+    return;
+  }
+
+  pool->ParallelFor(
+      0, extent, panel, [&](const size_t &first, const size_t &last) {
+        int begin = (int)first;
+        int size = (int)(last - first);
+        if (split_rows) {
+          Operand<T> a_part = a;
+          a_part.data += (size_t)begin * a.row_stride;
+          backend.Gemm(size, n, k, alpha, a_part, b, beta,
+                       c + (size_t)begin * ldc, ldc);
+        } else {
+          Operand<T> b_part = b;
+          b_part.data += (size_t)begin * b.col_stride;
+          backend.Gemm(m, size, k, alpha, a, b_part, beta, c + begin, ldc);
+        }
+      });
+}
+
+}  // namespace
+
+SimdLevel DetectSimdLevel() {
+#ifdef S21_KERNELS_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return SimdLevel::kAvx512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return SimdLevel::kAvx2;
+  }
+#endif
+  return SimdLevel::kScalar;
+}
+
+SimdLevel ActiveSimdLevel() { return Kernels<double>().level; }
+
+const char *SimdLevelName(const SimdLevel &level) {
+  switch (level) {
+    case SimdLevel::kAvx512:
+      return "avx512";
+    case SimdLevel::kAvx2:
+      return "avx2";
+    default:
+      return "scalar";
+  }
+}
+
+const char *ActivationName(const Activation &activation) {
+  switch (activation) {
+    case Activation::kRelu:
+      return "relu";
+    case Activation::kLeakyRelu:
+      return "leaky_relu";
+    case Activation::kTanh:
+      return "tanh";
+    default:
+      return "sigmoid";
+  }
+}
+
+bool ParseActivation(const char *name, Activation *activation) {
+  for (Activation candidate : {Activation::kSigmoid, Activation::kRelu,
+                               Activation::kLeakyRelu, Activation::kTanh}) {
+    if (std::strcmp(name, ActivationName(candidate)) == 0) {
+      *activation = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+namespace simd {
+
+void Gemv(const float *x, const float *w, int k, int n, int stride, float *y,
+          const float *bias) {
+  Kernels<float>().gemv(x, w, k, n, stride, y, bias, SigmoidMode::kPrecise);
+}
+
+void GemvSigmoid(const float *x, const float *w, int k, int n, int stride,
+                 float *y, const float *bias, const SigmoidMode &mode) {
+  Kernels<float>().gemv_sigmoid(x, w, k, n, stride, y, bias, mode);
+}
+
+void GemvSparse(const float *values, const int *index, int nnz,
+                const float *w, int n, int stride, float *y,
+                const float *bias) {
+  Kernels<float>().gemv_sparse(values, index, nnz, w, n, stride, y, bias,
+                               SigmoidMode::kPrecise);
+}
+
+void GemvSparseSigmoid(const float *values, const int *index, int nnz,
+                       const float *w, int n, int stride, float *y,
+                       const float *bias, const SigmoidMode &mode) {
+  Kernels<float>().gemv_sparse_sigmoid(values, index, nnz, w, n, stride, y,
+                                       bias, mode);
+}
+
+void GemvTransposed(const float *x, const float *w, int k, int n, int stride,
+                    float *y) {
+  Kernels<float>().gemv_transposed(x, w, k, n, stride, y);
+}
+
+void Sigmoid(float *data, int n, const SigmoidMode &mode) {
+  Kernels<float>().sigmoid(data, n, mode);
+}
+
+void Softmax(float *data, int n, const SigmoidMode &mode) {
+  Kernels<float>().softmax(data, n, mode);
+}
+
+void Activate(float *data, int n, const Activation &activation,
+              const SigmoidMode &mode) {
+  Kernels<float>().activate(data, n, activation, mode);
+}
+
+void ActivationDerivative(const float *output, float *delta, int n,
+                          const Activation &activation) {
+  Kernels<float>().activation_derivative(output, delta, n, activation);
+}
+
+void Ger(int m, int n, float alpha, const float *x, const float *y, float *a,
+         int lda) {
+  Kernels<float>().ger(m, n, alpha, x, y, a, lda);
+}
+
+void Gemm(int m, int n, int k, float alpha, const Operand<float> &a,
+          const Operand<float> &b, float beta, float *c, int ldc) {
+  Kernels<float>().gemm(m, n, k, alpha, a, b, beta, c, ldc);
+}
+
+void MomentumStep(float *w, const float *d, float *v, int n, float lr,
+                  float mu, bool nesterov) {
+  Kernels<float>().momentum_step(w, d, v, n, lr, mu, nesterov);
+}
+
+void AdamStep(float *w, const float *d, float *m, float *s, int n,
+              float step, float beta1, float beta2, float epsilon) {
+  Kernels<float>().adam_step(w, d, m, s, n, step, beta1, beta2, epsilon);
+}
+
+void Gemv(const double *x, const double *w, int k, int n, int stride,
+          double *y, const double *bias) {
+  Kernels<double>().gemv(x, w, k, n, stride, y, bias,
+                         SigmoidMode::kPrecise);
+}
+
+void GemvSigmoid(const double *x, const double *w, int k, int n, int stride,
+                 double *y, const double *bias, const SigmoidMode &mode) {
+  Kernels<double>().gemv_sigmoid(x, w, k, n, stride, y, bias, mode);
+}
+
+void GemvSparse(const double *values, const int *index, int nnz,
+                const double *w, int n, int stride, double *y,
+                const double *bias) {
+  Kernels<double>().gemv_sparse(values, index, nnz, w, n, stride, y, bias,
+                                SigmoidMode::kPrecise);
+}
+
+void GemvSparseSigmoid(const double *values, const int *index, int nnz,
+                       const double *w, int n, int stride, double *y,
+                       const double *bias, const SigmoidMode &mode) {
+  Kernels<double>().gemv_sparse_sigmoid(values, index, nnz, w, n, stride, y,
+                                        bias, mode);
+}
+
+void GemvTransposed(const double *x, const double *w, int k, int n,
+                    int stride, double *y) {
+  Kernels<double>().gemv_transposed(x, w, k, n, stride, y);
+}
+
+void Sigmoid(double *data, int n, const SigmoidMode &mode) {
+  Kernels<double>().sigmoid(data, n, mode);
+}
+
+void Softmax(double *data, int n, const SigmoidMode &mode) {
+  Kernels<double>().softmax(data, n, mode);
+}
+
+void Activate(double *data, int n, const Activation &activation,
+              const SigmoidMode &mode) {
+  Kernels<double>().activate(data, n, activation, mode);
+}
+
+void ActivationDerivative(const double *output, double *delta, int n,
+                          const Activation &activation) {
+  Kernels<double>().activation_derivative(output, delta, n, activation);
+}
+
+void Ger(int m, int n, double alpha, const double *x, const double *y,
+         double *a, int lda) {
+  Kernels<double>().ger(m, n, alpha, x, y, a, lda);
+}
+
+void Gemm(int m, int n, int k, double alpha, const Operand<double> &a,
+          const Operand<double> &b, double beta, double *c, int ldc) {
+  Kernels<double>().gemm(m, n, k, alpha, a, b, beta, c, ldc);
+}
+
+void MomentumStep(double *w, const double *d, double *v, int n, double lr,
+                  double mu, bool nesterov) {
+  Kernels<double>().momentum_step(w, d, v, n, lr, mu, nesterov);
+}
+
+void AdamStep(double *w, const double *d, double *m, double *s, int n,
+              double step, double beta1, double beta2, double epsilon) {
+  Kernels<double>().adam_step(w, d, m, s, n, step, beta1, beta2, epsilon);
+}
+
+}  // namespace simd
+
+void Gemv(const float *x, const float *w, int k, int n, int stride, float *y,
+          const float *bias) {
+  ActiveBackend<float>().Gemv(x, w, k, n, stride, y, bias);
+}
+
+void GemvSigmoid(const float *x, const float *w, int k, int n, int stride,
+                 float *y, const float *bias, const SigmoidMode &mode) {
+  ActiveBackend<float>().GemvSigmoid(x, w, k, n, stride, y, bias, mode);
+}
+
+void GemvSparse(const float *values, const int *index, int nnz,
+                const float *w, int n, int stride, float *y,
+                const float *bias) {
+  ActiveBackend<float>().GemvSparse(values, index, nnz, w, n, stride, y,
+                                    bias);
+}
+
+void GemvSparseSigmoid(const float *values, const int *index, int nnz,
+                       const float *w, int n, int stride, float *y,
+                       const float *bias, const SigmoidMode &mode) {
+  ActiveBackend<float>().GemvSparseSigmoid(values, index, nnz, w, n, stride,
+                                           y, bias, mode);
+}
+
+void GemvTransposed(const float *x, const float *w, int k, int n, int stride,
+                    float *y) {
+  ActiveBackend<float>().GemvTransposed(x, w, k, n, stride, y);
+}
+
+void Sigmoid(float *data, int n, const SigmoidMode &mode) {
+  ActiveBackend<float>().Sigmoid(data, n, mode);
+}
+
+void Softmax(float *data, int n, const SigmoidMode &mode) {
+  ActiveBackend<float>().Softmax(data, n, mode);
+}
+
+void Activate(float *data, int n, const Activation &activation,
+              const SigmoidMode &mode) {
+  ActiveBackend<float>().Activate(data, n, activation, mode);
+}
+
+void ActivationDerivative(const float *output, float *delta, int n,
+                          const Activation &activation) {
+  ActiveBackend<float>().ActivationDerivative(output, delta, n, activation);
+}
+
+void Ger(int m, int n, float alpha, const float *x, const float *y, float *a,
+         int lda) {
+  ActiveBackend<float>().Ger(m, n, alpha, x, y, a, lda);
+}
+
+void Gemm(int m, int n, int k, float alpha, const Operand<float> &a,
+          const Operand<float> &b, float beta, float *c, int ldc,
+          s21_network::ThreadPool *pool) {
+  GemmOnPool(m, n, k, alpha, a, b, beta, c, ldc, pool);
+}
+
+void MomentumStep(float *w, const float *d, float *v, int n, float lr,
+                  float mu, bool nesterov) {
+  ActiveBackend<float>().MomentumStep(w, d, v, n, lr, mu, nesterov);
+}
+
+void AdamStep(float *w, const float *d, float *m, float *s, int n,
+              float step, float beta1, float beta2, float epsilon) {
+  ActiveBackend<float>().AdamStep(w, d, m, s, n, step, beta1, beta2,
+                                  epsilon);
+}
+
+void Gemv(const double *x, const double *w, int k, int n, int stride, double *y,
+          const double *bias) {
+  ActiveBackend<double>().Gemv(x, w, k, n, stride, y, bias);
+}
+
+void GemvSigmoid(const double *x, const double *w, int k, int n, int stride,
+                 double *y, const double *bias, const SigmoidMode &mode) {
+  ActiveBackend<double>().GemvSigmoid(x, w, k, n, stride, y, bias, mode);
+}
+
+void GemvSparse(const double *values, const int *index, int nnz,
+                const double *w, int n, int stride, double *y,
+                const double *bias) {
+  ActiveBackend<double>().GemvSparse(values, index, nnz, w, n, stride, y,
+                                     bias);
+}
+
+void GemvSparseSigmoid(const double *values, const int *index, int nnz,
+                       const double *w, int n, int stride, double *y,
+                       const double *bias, const SigmoidMode &mode) {
+  ActiveBackend<double>().GemvSparseSigmoid(values, index, nnz, w, n, stride,
+                                            y, bias, mode);
+}
+
+void GemvTransposed(const double *x, const double *w, int k, int n,
+                    int stride, double *y) {
+  ActiveBackend<double>().GemvTransposed(x, w, k, n, stride, y);
+}
+
+void Sigmoid(double *data, int n, const SigmoidMode &mode) {
+  ActiveBackend<double>().Sigmoid(data, n, mode);
+}
+
+void Softmax(double *data, int n, const SigmoidMode &mode) {
+  ActiveBackend<double>().Softmax(data, n, mode);
+}
+
+void Activate(double *data, int n, const Activation &activation,
+              const SigmoidMode &mode) {
+  ActiveBackend<double>().Activate(data, n, activation, mode);
+}
+
+void ActivationDerivative(const double *output, double *delta, int n,
+                          const Activation &activation) {
+  ActiveBackend<double>().ActivationDerivative(output, delta, n, activation);
+}
+
+void Ger(int m, int n, double alpha, const double *x, const double *y,
+         double *a, int lda) {
+  ActiveBackend<double>().Ger(m, n, alpha, x, y, a, lda);
+}
+
+void Gemm(int m, int n, int k, double alpha, const Operand<double> &a,
+          const Operand<double> &b, double beta, double *c, int ldc,
+          s21_network::ThreadPool *pool) {
+  GemmOnPool(m, n, k, alpha, a, b, beta, c, ldc, pool);
+}
+
+void MomentumStep(double *w, const double *d, double *v, int n, double lr,
+                  double mu, bool nesterov) {
+  ActiveBackend<double>().MomentumStep(w, d, v, n, lr, mu, nesterov);
+}
+
+void AdamStep(double *w, const double *d, double *m, double *s, int n,
+              double step, double beta1, double beta2, double epsilon) {
+  ActiveBackend<double>().AdamStep(w, d, m, s, n, step, beta1, beta2,
+                                   epsilon);
+}
+
+}  // namespace s21_kernels
@@ -0,0 +1,220 @@
+#pragma once
+
+namespace s21_network {
+class ThreadPool;
+}  // namespace s21_network
+
+namespace s21_kernels {
+
+/*---наборы инструкций, под которые собраны ядра; лучший из поддерживаемых
+ * процессором выбирается один раз при запуске программы---*/
+enum class SimdLevel { kScalar, kAvx2, kAvx512 };
+
+SimdLevel DetectSimdLevel();
+SimdLevel ActiveSimdLevel();
+const char *SimdLevelName(const SimdLevel &level);
+
+/*---как считается сигмоида 1 / (1 + exp(-x)). Оба режима векторные и
+ * сводят exp к 2^n * exp(r), |r| <= ln2 / 2, разница только в степени
+ * многочлена для exp(r):
+ *   kPrecise - степень 12 для double и 7 для float, абсолютная ошибка
+ *              сигмоиды меньше 2e-16 и 1e-7 (около одного ulp)
+ *   kFast    - степень 4, абсолютная ошибка меньше 1.4e-5---*/
+enum class SigmoidMode { kPrecise, kFast };
+
+/*---функция активации слоя:
+ *   kSigmoid   - 1 / (1 + exp(-x))
+ *   kRelu      - max(x, 0)
+ *   kLeakyRelu - x при x > 0, иначе kLeakyReluSlope * x
+ *   kTanh      - 2 * sigmoid(2x) - 1, тот же многочлен exp, что у сигмоиды,
+ *                абсолютная ошибка вдвое больше, чем у нее---*/
+enum class Activation { kSigmoid, kRelu, kLeakyRelu, kTanh };
+
+constexpr double kLeakyReluSlope = 0.01;
+
+/*---"sigmoid", "relu", "leaky_relu" и "tanh" - имена в файлах весов---*/
+const char *ActivationName(const Activation &activation);
+/*---false, если имя не из этого списка---*/
+bool ParseActivation(const char *name, Activation *activation);
+
+/*---операнд-матрица только для чтения, элемент (i, j) - это
+ * data[i * row_stride + j * col_stride]; транспонированный операнд - та же
+ * память с переставленными шагами---*/
+template <class T>
+struct Operand {
+  const T *data;
+  int row_stride;
+  int col_stride;
+};
+
+/*---все ядра есть для float и для double. Функции ниже считает бэкенд,
+ * выбранный в вызывающем потоке (computeBackend.hpp), по умолчанию -
+ * векторные ядра пространства simd---*/
+
+/*---y[0..n) = x[0..k) * W (+ bias), W - матрица k x n по строкам с шагом
+ * строк stride элементов, bias необязателен---*/
+void Gemv(const float *x, const float *w, int k, int n, int stride, float *y,
+          const float *bias = nullptr);
+void Gemv(const double *x, const double *w, int k, int n, int stride,
+          double *y, const double *bias = nullptr);
+
+/*---то же произведение с сигмоидой от каждого элемента y---*/
+void GemvSigmoid(const float *x, const float *w, int k, int n, int stride,
+                 float *y, const float *bias = nullptr,
+                 const SigmoidMode &mode = SigmoidMode::kPrecise);
+void GemvSigmoid(const double *x, const double *w, int k, int n, int stride,
+                 double *y, const double *bias = nullptr,
+                 const SigmoidMode &mode = SigmoidMode::kPrecise);
+
+/*---y[0..n) = x * W (+ bias) для разреженного x длиной в число строк W,
+ * заданного nnz ненулевыми значениями и их индексами по возрастанию; строки
+ * W для нулевых элементов не читаются. Сумма та же, что дает Gemv для
+ * плотного x, без нулевых слагаемых---*/
+void GemvSparse(const float *values, const int *index, int nnz,
+                const float *w, int n, int stride, float *y,
+                const float *bias = nullptr);
+void GemvSparse(const double *values, const int *index, int nnz,
+                const double *w, int n, int stride, double *y,
+                const double *bias = nullptr);
+
+/*---то же с сигмоидой от каждого элемента y---*/
+void GemvSparseSigmoid(const float *values, const int *index, int nnz,
+                       const float *w, int n, int stride, float *y,
+                       const float *bias = nullptr,
+                       const SigmoidMode &mode = SigmoidMode::kPrecise);
+void GemvSparseSigmoid(const double *values, const int *index, int nnz,
+                       const double *w, int n, int stride, double *y,
+                       const double *bias = nullptr,
+                       const SigmoidMode &mode = SigmoidMode::kPrecise);
+
+/*---y[0..n) = x[0..k) * W^T, W - матрица n x k по строкам с шагом строк
+ * stride элементов: y[j] - скалярное произведение x на строку j матрицы W---*/
+void GemvTransposed(const float *x, const float *w, int k, int n, int stride,
+                    float *y);
+void GemvTransposed(const double *x, const double *w, int k, int n,
+                    int stride, double *y);
+
+/*---data[0..n) = sigmoid(data[0..n)) на месте---*/
+void Sigmoid(float *data, int n,
+             const SigmoidMode &mode = SigmoidMode::kPrecise);
+void Sigmoid(double *data, int n,
+             const SigmoidMode &mode = SigmoidMode::kPrecise);
+
+/*---data[0..n) = f(data[0..n)) на месте, mode выбирает многочлен exp для
+ * kSigmoid и kTanh---*/
+void Activate(float *data, int n, const Activation &activation,
+              const SigmoidMode &mode = SigmoidMode::kPrecise);
+void Activate(double *data, int n, const Activation &activation,
+              const SigmoidMode &mode = SigmoidMode::kPrecise);
+
+/*---delta[0..n) *= f'(x) для выходов слоя y = f(x), производная выражена
+ * через y: y * (1 - y), 1 или 0, 1 или kLeakyReluSlope, 1 - y^2---*/
+void ActivationDerivative(const float *output, float *delta, int n,
+                          const Activation &activation);
+void ActivationDerivative(const double *output, double *delta, int n,
+                          const Activation &activation);
+
+/*---data[0..n) = softmax(data[0..n)) на месте, exp(x - max) / sum: после
+ * сдвига на максимум exp не выходит за диапазон при любых входах. mode
+ * выбирает многочлен exp, как у сигмоиды---*/
+void Softmax(float *data, int n,
+             const SigmoidMode &mode = SigmoidMode::kPrecise);
+void Softmax(double *data, int n,
+             const SigmoidMode &mode = SigmoidMode::kPrecise);
+
+/*---A (m x n, шаг строк lda) += alpha * x^T * y, строки меняются на месте
+ * одна за другой. Строка с нулевым x[i] пропускается и даже не читается,
+ * поэтому разреженный x (пиксели цифры почти все пустые) стоит только его
+ * ненулевых строк---*/
+void Ger(int m, int n, float alpha, const float *x, const float *y, float *a,
+         int lda);
+void Ger(int m, int n, double alpha, const double *x, const double *y,
+         double *a, int lda);
+
+/*---C (m x n, шаг строк ldc) = alpha * A (m x k) * B (k x n) + beta * C,
+ * блоками под кэш и регистры; при beta == 0 C не читается, при beta == 1
+ * произведение прибавляется к C. С пулом pool большое произведение
+ * делится на панели строк или столбцов C, их считают потоки пула; у
+ * векторных ядер и эталона результат тот же, что без пула---*/
+void Gemm(int m, int n, int k, float alpha, const Operand<float> &a,
+          const Operand<float> &b, float beta, float *c, int ldc,
+          s21_network::ThreadPool *pool = nullptr);
+void Gemm(int m, int n, int k, double alpha, const Operand<double> &a,
+          const Operand<double> &b, double beta, double *c, int ldc,
+          s21_network::ThreadPool *pool = nullptr);
+
+/*---шаги оптимизаторов по n независимым весам w в направлении d
+ * (антиградиент ошибки):
+ *   MomentumStep - v = mu * v + d; w += lr * v, с nesterov
+ *                  w += lr * (d + mu * v)
+ *   AdamStep     - m = beta1 * m + (1 - beta1) * d,
+ *                  s = beta2 * s + (1 - beta2) * d^2,
+ *                  w += step * m / (sqrt(s) + epsilon)---*/
+void MomentumStep(float *w, const float *d, float *v, int n, float lr,
+                  float mu, bool nesterov);
+void MomentumStep(double *w, const double *d, double *v, int n, double lr,
+                  double mu, bool nesterov);
+void AdamStep(float *w, const float *d, float *m, float *s, int n,
+              float step, float beta1, float beta2, float epsilon);
+void AdamStep(double *w, const double *d, double *m, double *s, int n,
+              double step, double beta1, double beta2, double epsilon);
+
+/*---сами векторные ядра, без выбора бэкенда---*/
+namespace simd {
+
+void Gemv(const float *x, const float *w, int k, int n, int stride, float *y,
+          const float *bias);
+void Gemv(const double *x, const double *w, int k, int n, int stride,
+          double *y, const double *bias);
+void GemvSigmoid(const float *x, const float *w, int k, int n, int stride,
+                 float *y, const float *bias, const SigmoidMode &mode);
+void GemvSigmoid(const double *x, const double *w, int k, int n, int stride,
+                 double *y, const double *bias, const SigmoidMode &mode);
+void GemvSparse(const float *values, const int *index, int nnz,
+                const float *w, int n, int stride, float *y,
+                const float *bias);
+void GemvSparse(const double *values, const int *index, int nnz,
+                const double *w, int n, int stride, double *y,
+                const double *bias);
+void GemvSparseSigmoid(const float *values, const int *index, int nnz,
+                       const float *w, int n, int stride, float *y,
+                       const float *bias, const SigmoidMode &mode);
+void GemvSparseSigmoid(const double *values, const int *index, int nnz,
+                       const double *w, int n, int stride, double *y,
+                       const double *bias, const SigmoidMode &mode);
+void GemvTransposed(const float *x, const float *w, int k, int n, int stride,
+                    float *y);
+void GemvTransposed(const double *x, const double *w, int k, int n,
+                    int stride, double *y);
+void Sigmoid(float *data, int n, const SigmoidMode &mode);
+void Sigmoid(double *data, int n, const SigmoidMode &mode);
+void Softmax(float *data, int n, const SigmoidMode &mode);
+void Softmax(double *data, int n, const SigmoidMode &mode);
+void Activate(float *data, int n, const Activation &activation,
+              const SigmoidMode &mode);
+void Activate(double *data, int n, const Activation &activation,
+              const SigmoidMode &mode);
+void ActivationDerivative(const float *output, float *delta, int n,
+                          const Activation &activation);
+void ActivationDerivative(const double *output, double *delta, int n,
+                          const Activation &activation);
+void Ger(int m, int n, float alpha, const float *x, const float *y, float *a,
+         int lda);
+void Ger(int m, int n, double alpha, const double *x, const double *y,
+         double *a, int lda);
+void Gemm(int m, int n, int k, float alpha, const Operand<float> &a,
+          const Operand<float> &b, float beta, float *c, int ldc);
+void Gemm(int m, int n, int k, double alpha, const Operand<double> &a,
+          const Operand<double> &b, double beta, double *c, int ldc);
+void MomentumStep(float *w, const float *d, float *v, int n, float lr,
+                  float mu, bool nesterov);
+void MomentumStep(double *w, const double *d, double *v, int n, double lr,
+                  double mu, bool nesterov);
+void AdamStep(float *w, const float *d, float *m, float *s, int n,
+              float step, float beta1, float beta2, float epsilon);
+void AdamStep(double *w, const double *d, double *m, double *s, int n,
+              double step, double beta1, double beta2, double epsilon);
+
+}  // namespace simd
+
+}  // namespace s21_kernels
@@ -4,8 +4,22 @@ namespace s21_network {
 
 /*––––––––––– class MatrixNetwork –––––––––––––––––*/
 
-MatrixNetwork::MatrixNetwork(const int &sum_hidden_layers,
-                             const double &learn_rate)
+MatrixNetwork *MatrixNetwork::Create(const int &sum_hidden_layers,
+                                     const double &learning_rate,
+                                     const ScalarType &scalar_type) {
+  if (scalar_type == ScalarType::kFloat) {
+    return new BasicMatrixNetwork<float>(sum_hidden_layers, learning_rate);
+  }
+  return new BasicMatrixNetwork<double>(sum_hidden_layers, learning_rate);
+}
+
+/*–––––––––––––––––––––––––––––––––––––––––––––––--*/
+
+/*––––––––––– class BasicMatrixNetwork ––––––––––––*/
+
+template <typename T>
+BasicMatrixNetwork<T>::BasicMatrixNetwork(const int &sum_hidden_layers,
+                                          const double &learn_rate)
     : input_layer_(nullptr),
       output_layer_(nullptr),
       learning_rate_(learn_rate) {
@@ -14,9 +28,13 @@ MatrixNetwork::MatrixNetwork(const int &sum_hidden_layers,
         "Error in constructor MatrixNetwork, argument < 1");
   }
 
+  /*---все матрицы сигналов и дельт создаются здесь один раз, обучение и
+   * распознавание дальше только перезаписывают их---*/
+  input_layer_ = new S21Matrix<T>(1, kInputLayer);
+
   /*---добавляем первый слой, его матрица весов зависит от входного слоя---*/
   hidden_layers_.push_back(
-      new HiddenLayer(kInputLayer, kSumNeironsHiddenLayer));
+      new HiddenLayer(kInputLayer, kSumNeironsHiddenLayer, true));
 
   /*---добавляем остальные скрытые слой, если они есть---*/
   for (int i = 1; i < sum_hidden_layers; ++i) {
@@ -29,7 +47,8 @@ MatrixNetwork::MatrixNetwork(const int &sum_hidden_layers,
       new OutputLayer(kSumNeironsHiddenLayer, kSumNeironsOutputLayer);
 }
 
-MatrixNetwork::~MatrixNetwork() {
+template <typename T>
+BasicMatrixNetwork<T>::~BasicMatrixNetwork() {
   if (input_layer_ != nullptr) {
     delete input_layer_;
   }
@@ -41,8 +60,14 @@ MatrixNetwork::~MatrixNetwork() {
   }
 }
 
-void MatrixNetwork::InstallRandomWeights() {
-  srand(time(NULL));
+template <typename T>
+void BasicMatrixNetwork<T>::InstallRandomWeights() {
+  InstallRandomWeights(time(NULL));
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::InstallRandomWeights(const unsigned &seed) {
+  srand(seed);
   /*---устанавливаем рандомные веса для скрытых слоев---*/
   size_t sum_hidden_layers = hidden_layers_.size();
   for (size_t index_layer = 0; index_layer < sum_hidden_layers; ++index_layer) {
@@ -52,7 +77,8 @@ void MatrixNetwork::InstallRandomWeights() {
   output_layer_->InstallRandomWeights();
 }
 
-void MatrixNetwork::LoadWeights(const std::string &filename) {
+template <typename T>
+void BasicMatrixNetwork<T>::LoadWeights(const std::string &filename) {
   std::ifstream stream(filename);
   if (stream.is_open()) {
     setlocale(LC_ALL, "en_US.UTF-8");
@@ -65,6 +91,12 @@ void MatrixNetwork::LoadWeights(const std::string &filename) {
       std::getline(stream, type_network);
       if (type_network ==
           (std::to_string(hidden_layers_.size()) + " Hiddens Layers")) {
+        /*---функции активации скрытых слоев, если файл их записал---*/
+        std::vector<s21_kernels::Activation> activations =
+            ReadActivations(&stream, hidden_layers_.size());
+        for (size_t i = 0; i < hidden_layers_.size(); ++i) {
+          hidden_layers_[i]->set_activation(activations[i]);
+        }
         /*---загружаем веса скрытых слоев---*/
         for (size_t i = 0; i < hidden_layers_.size(); ++i) {
           hidden_layers_[i]->LoadWeights(&stream);
@@ -87,7 +119,8 @@ void MatrixNetwork::LoadWeights(const std::string &filename) {
   }
 }
 
-void MatrixNetwork::SaveWeights(const std::string &filename) {
+template <typename T>
+void BasicMatrixNetwork<T>::SaveWeights(const std::string &filename) {
   std::ofstream stream(filename);
   if (stream.is_open()) {
     setlocale(LC_ALL, "en_US.UTF-8");
@@ -97,6 +130,11 @@ void MatrixNetwork::SaveWeights(const std::string &filename) {
     /*---вторая строка файла, это количетсво скрытых слоев данной сети---*/
     stream << std::to_string(hidden_layers_.size()) + " Hiddens Layers"
            << std::endl;
+    std::vector<s21_kernels::Activation> activations{};
+    for (size_t i = 0; i < hidden_layers_.size(); ++i) {
+      activations.push_back(hidden_layers_[i]->get_activation());
+    }
+    WriteActivations(activations, &stream);
     /*---далее сохраняем веса скрытых слоев---*/
     for (size_t i = 0; i < hidden_layers_.size(); ++i) {
       hidden_layers_[i]->SaveWeights(&stream);
@@ -107,13 +145,106 @@ void MatrixNetwork::SaveWeights(const std::string &filename) {
   }
 }
 
-size_t MatrixNetwork::Prediction(const std::vector<unsigned> &input_layer) {
+template <typename T>
+std::vector<double> BasicMatrixNetwork<T>::GetWeights() const {
+  std::vector<double> weights{};
+  for (size_t i = 0; i < hidden_layers_.size(); ++i) {
+    hidden_layers_[i]->GetWeights(&weights);
+  }
+  output_layer_->GetWeights(&weights);
+  return weights;
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::SetWeights(const std::vector<double> &weights) {
+  size_t sum_weights = 0;
+  for (size_t i = 0; i <= hidden_layers_.size(); ++i) {
+    HiddenLayer *layer =
+        i < hidden_layers_.size() ? hidden_layers_[i] : output_layer_;
+    const S21Matrix<T> &layer_weights = layer->get_weights_matrix();
+    sum_weights +=
+        (size_t)layer_weights.get_rows() * layer_weights.get_columns();
+  }
+  if (weights.size() != sum_weights) {
+    throw std::invalid_argument(
+        "Error in SetWeights(), network has " + std::to_string(sum_weights) +
+        " weights, but got " + std::to_string(weights.size()));
+  }
+  size_t offset = 0;
+  for (size_t i = 0; i < hidden_layers_.size(); ++i) {
+    hidden_layers_[i]->SetWeights(weights, &offset);
+  }
+  output_layer_->SetWeights(weights, &offset);
+}
+
+template <typename T>
+size_t BasicMatrixNetwork<T>::Prediction(
+    const std::vector<unsigned> &input_layer) {
   FeedForward(input_layer);
   return output_layer_->ResultNeiron();
 }
 
-void MatrixNetwork::LearnNetwork(const std::vector<unsigned> &input_layer,
-                                 const size_t &expected_value) {
+template <typename T>
+void BasicMatrixNetwork<T>::PredictBatch(const uint8_t *pixels,
+                                         const size_t &n,
+                                         size_t *out_labels) {
+  s21_kernels::BackendScope backend(backend_);
+
+  /*---каждая часть пакета - матрица входного слоя, на каждый слой одно
+   * произведение матриц---*/
+  for (size_t first = 0; first < n; first += kPredictBatchRows) {
+    size_t count = std::min(kPredictBatchRows, n - first);
+    SetInputRows(pixels + first * kInputLayer, count, input_layer_);
+    FeedForwardInputLayer();
+    for (size_t i = 0; i < count; ++i) {
+      out_labels[first + i] = output_layer_->ResultNeiron(i);
+    }
+  }
+}
+
+template <typename T>
+InferenceWorkspace *BasicMatrixNetwork<T>::CreateWorkspace() const {
+  return new Workspace(hidden_layers_.size());
+}
+
+template <typename T>
+size_t BasicMatrixNetwork<T>::Prediction(
+    const std::vector<unsigned> &input_layer,
+    InferenceWorkspace *workspace) const {
+  Workspace *own = CheckWorkspace(workspace);
+  s21_kernels::BackendScope backend(backend_);
+
+  own->input.Resize(1, kInputLayer);
+  SetInputRow(input_layer, 0, &own->input);
+  FeedForwardWorkspace(own);
+  return OutputLayer::ResultNeiron(own->outputs.back(), 0);
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::PredictBatch(const uint8_t *pixels,
+                                         const size_t &n, size_t *out_labels,
+                                         InferenceWorkspace *workspace) const {
+  Workspace *own = CheckWorkspace(workspace);
+  s21_kernels::BackendScope backend(backend_);
+
+  /*---как PredictBatch выше, но все сигналы пишутся в workspace---*/
+  for (size_t first = 0; first < n; first += kPredictBatchRows) {
+    size_t count = std::min(kPredictBatchRows, n - first);
+    SetInputRows(pixels + first * kInputLayer, count, &own->input);
+    FeedForwardWorkspace(own);
+    for (size_t i = 0; i < count; ++i) {
+      out_labels[first + i] =
+          OutputLayer::ResultNeiron(own->outputs.back(), i);
+    }
+  }
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::LearnNetwork(
+    const std::vector<unsigned> &input_layer, const size_t &expected_value) {
+  /*---все ядра в этом вызове считает выбранный бэкенд---*/
+  s21_kernels::BackendScope backend(backend_);
+
   /*---задаем ожидаемое значени---*/
   output_layer_->set_expected_value(expected_value);
 
@@ -124,64 +255,421 @@ void MatrixNetwork::LearnNetwork(const std::vector<unsigned> &input_layer,
   CorrectWeights();
 }
 
-void MatrixNetwork::FeedForward(const std::vector<unsigned> &input_layer) {
+template <typename T>
+void BasicMatrixNetwork<T>::LearnNetwork(
+    const std::vector<unsigned> &input_layer, const size_t &expected_value,
+    InferenceWorkspace *workspace) {
+  Workspace *own = CheckWorkspace(workspace);
+  if (optimizer_config_.type != OptimizerType::kSgd) {
+    throw std::invalid_argument(
+        "Error, learning with a workspace needs the plain SGD step");
+  }
+  s21_kernels::BackendScope backend(backend_);
+
+  own->input.Resize(1, kInputLayer);
+  SetInputRow(input_layer, 0, &own->input);
+  OutputLayer::SetTargetRow(expected_value, 0, &own->target);
+  FeedForwardWorkspace(own);
+  CorrectWeightsWorkspace(own);
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::LearnBatch(
+    const std::vector<std::vector<unsigned>> &samples,
+    const std::vector<size_t> &labels, const size_t &batch_size) {
+  if (batch_size < 1) {
+    throw std::invalid_argument("Error in LearnBatch(), batch_size < 1");
+  }
+  if (samples.size() != labels.size()) {
+    throw std::invalid_argument(
+        "Error in LearnBatch(), number of samples and labels differ");
+  }
+  s21_kernels::BackendScope backend(backend_);
+
+  /*---каждый пакет - матрица из count строк, сигналы и дельты слоев
+   * считаются для всех его примеров сразу блочным умножением---*/
+  for (size_t first = 0; first < samples.size(); first += batch_size) {
+    size_t count = std::min(batch_size, samples.size() - first);
+    output_layer_->set_expected_values(labels, first, count);
+    set_input_layer(samples, first, count);
+    FeedForwardInputLayer();
+    CorrectWeights();
+  }
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::AccumulateGradient(
+    const std::vector<std::vector<unsigned>> &samples,
+    const std::vector<size_t> &labels, const size_t &first,
+    const size_t &count, InferenceWorkspace *workspace) const {
+  Workspace *own = CheckWorkspace(workspace);
+  if (samples.size() != labels.size() || first + count > samples.size()) {
+    throw std::invalid_argument(
+        "Error in AccumulateGradient(), samples out of range");
+  }
+  s21_kernels::BackendScope backend(backend_);
+
+  size_t sum_hidden_layers = hidden_layers_.size();
+  std::vector<S21Matrix<T>> &gradients = own->gradients;
+  if (gradients.empty()) {
+    gradients.emplace_back(kInputLayer, kSumNeironsHiddenLayer);
+    for (size_t i = 1; i < sum_hidden_layers; ++i) {
+      gradients.emplace_back(kSumNeironsHiddenLayer, kSumNeironsHiddenLayer);
+    }
+    gradients.emplace_back(kSumNeironsHiddenLayer, kSumNeironsOutputLayer);
+  }
+  for (auto &gradient : gradients) gradient.SetZero();
+  if (count == 0) {
+    return;
+  }
+
+  own->input.Resize(count, kInputLayer);
+  own->target.Resize(count, kSumNeironsOutputLayer);
+  for (size_t i = 0; i < count; ++i) {
+    SetInputRow(samples[first + i], i, &own->input);
+    OutputLayer::SetTargetRow(labels[first + i], i, &own->target);
+  }
+  FeedForwardWorkspace(own);
+  CalcDeltasWorkspace(own);
+
+  /*---градиенты всех примеров части складывает одно произведение
+   * prev^T * delta на слой---*/
+  for (size_t i = 0; i <= sum_hidden_layers; ++i) {
+    const S21Matrix<T> &input = i == 0 ? own->input : own->outputs[i - 1];
+    gradients[i].AddProduct(input, own->deltas[i], T(1), true, false, pool_);
+  }
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::AddGradient(InferenceWorkspace *source,
+                                        InferenceWorkspace *target) const {
+  Workspace *from = CheckWorkspace(source);
+  Workspace *to = CheckWorkspace(target);
+  if (from->gradients.size() != to->gradients.size()) {
+    throw std::invalid_argument(
+        "Error in AddGradient(), one of the workspaces has no gradient");
+  }
+  /*---матрицы одного размера, поэтому и выравнивание строк одно, суммы
+   * складываются одним массивом---*/
+  for (size_t i = 0; i < to->gradients.size(); ++i) {
+    S21Matrix<T> &gradient = to->gradients[i];
+    const T *add = from->gradients[i].data();
+    T *sum = gradient.data();
+    size_t n = (size_t)gradient.get_rows() * gradient.get_stride();
+    for (size_t j = 0; j < n; ++j) sum[j] += add[j];
+  }
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::ApplyGradient(InferenceWorkspace *workspace,
+                                          const size_t &sum_samples) {
+  Workspace *own = CheckWorkspace(workspace);
+  if (own->gradients.empty() || sum_samples < 1) {
+    throw std::invalid_argument(
+        "Error in ApplyGradient(), workspace has no gradient");
+  }
+  s21_kernels::BackendScope backend(backend_);
+
+  output_layer_->ApplyGradient(own->gradients.back(), sum_samples,
+                               learning_rate_);
+  for (size_t i = 0; i < hidden_layers_.size(); ++i) {
+    hidden_layers_[i]->ApplyGradient(own->gradients[i], sum_samples,
+                                     learning_rate_);
+  }
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::PredictProbabilities(
+    const std::vector<unsigned> &input_layer,
+    std::vector<double> *probabilities) {
+  FeedForward(input_layer);
+  const S21Matrix<T> &output = output_layer_->get_output_matrix();
+  const T *values = output.row(0);
+  probabilities->assign(values, values + output.get_columns());
+  if (output_layer_->get_output_type() == OutputType::kSigmoid) {
+    double sum = 0;
+    for (double value : *probabilities) sum += value;
+    for (double &value : *probabilities) value /= sum;
+  }
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::set_output_type(const OutputType &type) {
+  output_layer_->set_output_type(type);
+}
+
+template <typename T>
+OutputType BasicMatrixNetwork<T>::get_output_type() const {
+  return output_layer_->get_output_type();
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::set_activation(
+    const size_t &layer, const s21_kernels::Activation &activation) {
+  CheckHiddenLayer(layer);
+  hidden_layers_[layer]->set_activation(activation);
+}
+
+template <typename T>
+s21_kernels::Activation BasicMatrixNetwork<T>::get_activation(
+    const size_t &layer) const {
+  CheckHiddenLayer(layer);
+  return hidden_layers_[layer]->get_activation();
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::CheckHiddenLayer(const size_t &layer) const {
+  if (layer >= hidden_layers_.size()) {
+    throw std::out_of_range("Error, network has " +
+                            std::to_string(hidden_layers_.size()) +
+                            " hidden layers, no layer " +
+                            std::to_string(layer));
+  }
+}
+
+template <typename T>
+ScalarType BasicMatrixNetwork<T>::get_scalar_type() const {
+  return std::is_same<T, float>::value ? ScalarType::kFloat
+                                       : ScalarType::kDouble;
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::set_sigmoid_mode(
+    const s21_kernels::SigmoidMode &mode) {
+  sigmoid_mode_ = mode;
+}
+
+template <typename T>
+s21_kernels::SigmoidMode BasicMatrixNetwork<T>::get_sigmoid_mode() const {
+  return sigmoid_mode_;
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::set_optimizer(const OptimizerConfig &config) {
+  /*---у каждого слоя свой оптимизатор со своим состоянием; при ошибке в
+   * параметрах исключение вылетит до того, как слои что-то получат---*/
+  std::vector<Optimizer<T> *> optimizers;
+  for (size_t i = 0; i <= hidden_layers_.size(); ++i) {
+    optimizers.push_back(Optimizer<T>::Create(config));
+  }
+  for (size_t i = 0; i < hidden_layers_.size(); ++i) {
+    hidden_layers_[i]->set_optimizer(optimizers[i]);
+  }
+  output_layer_->set_optimizer(optimizers.back());
+  optimizer_config_ = config;
+}
+
+template <typename T>
+OptimizerConfig BasicMatrixNetwork<T>::get_optimizer() const {
+  return optimizer_config_;
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::set_learning_rate(const double &learning_rate) {
+  if (learning_rate > 0) learning_rate_ = learning_rate;
+}
+
+template <typename T>
+double BasicMatrixNetwork<T>::get_learning_rate() const {
+  return learning_rate_;
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::set_backend(
+    const s21_kernels::BackendType &backend) {
+  if (!s21_kernels::IsBackendAvailable(backend)) {
+    throw std::invalid_argument(
+        std::string("backend isn't built in: ") +
+        s21_kernels::BackendName(backend));
+  }
+  backend_ = backend;
+}
+
+template <typename T>
+s21_kernels::BackendType BasicMatrixNetwork<T>::get_backend() const {
+  return backend_;
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::set_thread_pool(ThreadPool *pool) {
+  pool_ = pool;
+  for (auto *layer : hidden_layers_) layer->set_thread_pool(pool);
+  output_layer_->set_thread_pool(pool);
+}
+
+template <typename T>
+ThreadPool *BasicMatrixNetwork<T>::get_thread_pool() const {
+  return pool_;
+}
+
+template <typename T>
+InterfaceNetwork *BasicMatrixNetwork<T>::Clone() const {
+  auto *copy = new BasicMatrixNetwork<T>((int)hidden_layers_.size(),
+                                         learning_rate_);
+  copy->set_backend(backend_);
+  copy->set_thread_pool(pool_);
+  CopySettings(hidden_layers_.size(), copy);
+  return copy;
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::FeedForward(
+    const std::vector<unsigned> &input_layer) {
+  s21_kernels::BackendScope backend(backend_);
+
   /*---задаем входной слой---*/
   set_input_layer(input_layer);
+  FeedForwardInputLayer();
+}
 
+template <typename T>
+void BasicMatrixNetwork<T>::FeedForwardInputLayer() {
   /*---счиатем значения первого слоя, они зависят от входного слоя---*/
-  hidden_layers_.front()->CalcOutputMatrix(*input_layer_);
+  hidden_layers_.front()->CalcOutputMatrix(*input_layer_, sigmoid_mode_);
 
   /*---счиатем значения оставшихся слоев, если они есть---*/
   size_t sumHiddensLayer = hidden_layers_.size();
   for (size_t i = 1; i < sumHiddensLayer; ++i) {
     hidden_layers_[i]->CalcOutputMatrix(
-        hidden_layers_[i - 1]->get_output_matrix());
+        hidden_layers_[i - 1]->get_output_matrix(), sigmoid_mode_);
   }
 
   /*---счиатем значения выходного слоя---*/
-  output_layer_->CalcOutputMatrix(hidden_layers_.back()->get_output_matrix());
+  output_layer_->CalcOutputMatrix(hidden_layers_.back()->get_output_matrix(),
+                                  sigmoid_mode_);
 }
 
-void MatrixNetwork::set_input_layer(const std::vector<unsigned> &input_layer) {
-  if (input_layer_ != nullptr) {
-    delete input_layer_;
+template <typename T>
+typename BasicMatrixNetwork<T>::Workspace *
+BasicMatrixNetwork<T>::CheckWorkspace(InferenceWorkspace *workspace) const {
+  Workspace *own = dynamic_cast<Workspace *>(workspace);
+  if (own == nullptr || own->outputs.size() != hidden_layers_.size() + 1) {
+    throw std::invalid_argument(
+        "Error, workspace wasn't created by this network");
+  }
+  return own;
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::FeedForwardWorkspace(Workspace *workspace) const {
+  std::vector<S21Matrix<T>> &outputs = workspace->outputs;
+  hidden_layers_.front()->CalcOutputMatrix(
+      workspace->input, sigmoid_mode_, &outputs.front(),
+      workspace->active_index.data(), workspace->active_values.data());
+
+  size_t sum_hidden_layers = hidden_layers_.size();
+  for (size_t i = 1; i < sum_hidden_layers; ++i) {
+    hidden_layers_[i]->CalcOutputMatrix(outputs[i - 1], sigmoid_mode_,
+                                        &outputs[i], nullptr, nullptr);
+  }
+
+  output_layer_->CalcOutputMatrix(outputs[sum_hidden_layers - 1],
+                                  sigmoid_mode_, &outputs.back(), nullptr,
+                                  nullptr);
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::CalcDeltasWorkspace(Workspace *workspace) const {
+  /*---как в CorrectWeights, от выходного слоя к первому---*/
+  std::vector<S21Matrix<T>> &outputs = workspace->outputs;
+  std::vector<S21Matrix<T>> &deltas = workspace->deltas;
+  output_layer_->CalcWeightsDeltaMatrix(outputs.back(), workspace->target,
+                                        &deltas.back());
+  HiddenLayer *next_layer = output_layer_;
+  for (size_t i = hidden_layers_.size(); i-- > 0;) {
+    hidden_layers_[i]->CalcWeightsDeltaMatrix(
+        outputs[i], deltas[i + 1], next_layer->get_weights_matrix(),
+        &deltas[i]);
+    next_layer = hidden_layers_[i];
+  }
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::CorrectWeightsWorkspace(Workspace *workspace) {
+  /*---как CorrectWeights, но сигналы и дельты слоев берутся из
+   * workspace---*/
+  CalcDeltasWorkspace(workspace);
+  std::vector<S21Matrix<T>> &outputs = workspace->outputs;
+  std::vector<S21Matrix<T>> &deltas = workspace->deltas;
+  size_t sum_hidden_layers = hidden_layers_.size();
+  output_layer_->CorrectWeights(outputs[sum_hidden_layers - 1],
+                                deltas.back(), learning_rate_);
+  for (size_t i = 0; i < sum_hidden_layers; ++i) {
+    const S21Matrix<T> &input = i == 0 ? workspace->input : outputs[i - 1];
+    hidden_layers_[i]->CorrectWeights(input, deltas[i], learning_rate_);
+  }
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::set_input_layer(
+    const std::vector<unsigned> &input_layer) {
+  input_layer_->Resize(1, kInputLayer);
+  SetInputRow(input_layer, 0, input_layer_);
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::set_input_layer(
+    const std::vector<std::vector<unsigned>> &samples, const size_t &first,
+    const size_t &count) {
+  /*---матрица входного слоя перевыделяется, только если меняется размер
+   * пакета---*/
+  input_layer_->Resize(count, kInputLayer);
+  for (size_t i = 0; i < count; ++i) {
+    SetInputRow(samples[first + i], i, input_layer_);
   }
+}
 
+template <typename T>
+void BasicMatrixNetwork<T>::SetInputRow(
+    const std::vector<unsigned> &input_layer, const int &row,
+    S21Matrix<T> *input_matrix) {
   size_t len_input_layer = input_layer.size();
-  input_layer_ = new S21Matrix(1, len_input_layer);
+  if (len_input_layer != kInputLayer) {
+    throw std::invalid_argument(
+        "Error, size of input layer must be " + std::to_string(kInputLayer) +
+        ", but got " + std::to_string(len_input_layer));
+  }
 
+  T *input = input_matrix->row(row);
   for (size_t i = 0; i < len_input_layer; ++i) {
-    (*input_layer_)(0, i) = (double)input_layer[i] / 255;
+    input[i] = (T)input_layer[i] / 255;
   }
 }
 
-void MatrixNetwork::CorrectWeights() {
-  /*---вычисляем m_weightsDelta_ выходного слоя---*/
+template <typename T>
+void BasicMatrixNetwork<T>::SetInputRows(const uint8_t *pixels,
+                                         const size_t &count,
+                                         S21Matrix<T> *input_matrix) {
+  /*---матрица перевыделяется, только если меняется число строк---*/
+  input_matrix->Resize(count, kInputLayer);
+  for (size_t i = 0; i < count; ++i) {
+    const uint8_t *image = pixels + i * kInputLayer;
+    T *input = input_matrix->row(i);
+    for (size_t j = 0; j < kInputLayer; ++j) {
+      input[j] = (T)image[j] / 255;
+    }
+  }
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::CorrectWeights() {
+  /*---сначала считаем дельты всех слоев от выходного к первому, пока веса
+   * еще не изменены---*/
   output_layer_->CalcWeightsDeltaMatrix();
+  HiddenLayer *next_layer = output_layer_;
+  for (auto it = hidden_layers_.rbegin(); it != hidden_layers_.rend(); ++it) {
+    (*it)->CalcWeightsDeltaMatrix(next_layer->get_weights_delta_matrix(),
+                                  next_layer->get_weights_matrix());
+    next_layer = *it;
+  }
 
-  /*---корректируем веса выходного слоя---*/
+  /*---затем корректируем веса каждого слоя по сигналам предыдущего---*/
   output_layer_->CorrectWeights(hidden_layers_.back()->get_output_matrix(),
                                 learning_rate_);
-
-  /*---далее корректируем веса в обратном порядке от выходного слоя---*/
-
-  unsigned int sum_hiddens = hidden_layers_.size() - 1;
-  for (int index_layer = sum_hiddens; index_layer >= 0; --index_layer) {
-    if (index_layer == (int)sum_hiddens) {
-      hidden_layers_[index_layer]->CalcWeightsDeltaMatrix(
-          output_layer_->get_weights_delta_matrix());
-    } else {
-      hidden_layers_[index_layer]->CalcWeightsDeltaMatrix(
-          hidden_layers_[index_layer + 1]->get_weights_delta_matrix());
-    }
-
-    if (index_layer != 0) {
-      hidden_layers_[index_layer]->CorrectWeights(
-          hidden_layers_[index_layer - 1]->get_output_matrix(), learning_rate_);
-    } else {
-      hidden_layers_[index_layer]->CorrectWeights(*input_layer_,
-                                                  learning_rate_);
-    }
+  for (size_t i = 0; i < hidden_layers_.size(); ++i) {
+    const S21Matrix<T> &input =
+        i == 0 ? *input_layer_ : hidden_layers_[i - 1]->get_output_matrix();
+    hidden_layers_[i]->CorrectWeights(input, learning_rate_);
   }
 }
 
@@ -189,16 +677,30 @@ void MatrixNetwork::CorrectWeights() {
 
 /*––––––––––– class HiddenLayer –––––––––––––––––*/
 
-MatrixNetwork::HiddenLayer::HiddenLayer(const unsigned &rows_weight_layer,
-                                        const unsigned &cols_weight_layer)
+template <typename T>
+BasicMatrixNetwork<T>::HiddenLayer::HiddenLayer(
+    const unsigned &rows_weight_layer, const unsigned &cols_weight_layer,
+    const bool &sparse_input)
     : m_output_(nullptr),
       m_weights_(nullptr),
       m_weights_delta_(nullptr),
-      sum_neirons_(cols_weight_layer) {
-  m_weights_ = new S21Matrix(rows_weight_layer, cols_weight_layer);
+      optimizer_(nullptr),
+      m_direction_(nullptr),
+      sum_neirons_(cols_weight_layer),
+      sparse_input_(sparse_input),
+      activation_(s21_kernels::Activation::kSigmoid),
+      pool_(nullptr) {
+  m_weights_ = new S21Matrix<T>(rows_weight_layer, cols_weight_layer);
+  m_output_ = new S21Matrix<T>(1, cols_weight_layer);
+  m_weights_delta_ = new S21Matrix<T>(1, cols_weight_layer);
+  if (sparse_input_) {
+    active_index_.resize(rows_weight_layer);
+    active_values_.resize(rows_weight_layer);
+  }
 }
 
-MatrixNetwork::HiddenLayer::~HiddenLayer() {
+template <typename T>
+BasicMatrixNetwork<T>::HiddenLayer::~HiddenLayer() {
   if (m_output_ != nullptr) {
     delete m_output_;
   }
@@ -208,9 +710,46 @@ MatrixNetwork::HiddenLayer::~HiddenLayer() {
   if (m_weights_delta_ != nullptr) {
     delete m_weights_delta_;
   }
+  if (optimizer_ != nullptr) {
+    delete optimizer_;
+  }
+  if (m_direction_ != nullptr) {
+    delete m_direction_;
+  }
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::HiddenLayer::set_optimizer(
+    Optimizer<T> *optimizer) {
+  if (optimizer_ != nullptr) {
+    delete optimizer_;
+  }
+  optimizer_ = optimizer;
+  if (optimizer_ != nullptr && m_direction_ == nullptr) {
+    m_direction_ = new S21Matrix<T>(m_weights_->get_rows(),
+                                    m_weights_->get_columns());
+  }
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::HiddenLayer::set_activation(
+    const s21_kernels::Activation &activation) {
+  activation_ = activation;
+}
+
+template <typename T>
+const s21_kernels::Activation &
+BasicMatrixNetwork<T>::HiddenLayer::get_activation() const {
+  return activation_;
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::HiddenLayer::set_thread_pool(ThreadPool *pool) {
+  pool_ = pool;
 }
 
-void MatrixNetwork::HiddenLayer::LoadWeights(std::ifstream *stream) {
+template <typename T>
+void BasicMatrixNetwork<T>::HiddenLayer::LoadWeights(std::ifstream *stream) {
   std::string line{};
   std::string value{};
 
@@ -243,7 +782,8 @@ void MatrixNetwork::HiddenLayer::LoadWeights(std::ifstream *stream) {
   }
 }
 
-void MatrixNetwork::HiddenLayer::SaveWeights(std::ofstream *stream) {
+template <typename T>
+void BasicMatrixNetwork<T>::HiddenLayer::SaveWeights(std::ofstream *stream) {
   size_t row = m_weights_->get_rows();
   size_t col = m_weights_->get_columns();
 
@@ -260,89 +800,242 @@ void MatrixNetwork::HiddenLayer::SaveWeights(std::ofstream *stream) {
   *stream << "Layer weights are over" << std::endl;
 }
 
-void MatrixNetwork::HiddenLayer::CorrectWeights(
-    const S21Matrix &output_matrix_prev_layer, const double &learning_rate) {
-  if (m_weights_delta_ == nullptr) {
-    throw std::out_of_range("can't correct weight, delta matrix is nullptr");
+template <typename T>
+void BasicMatrixNetwork<T>::HiddenLayer::GetWeights(
+    std::vector<double> *weights) const {
+  int rows = m_weights_->get_rows();
+  int columns = m_weights_->get_columns();
+  for (int i = 0; i < rows; ++i) {
+    const T *line = m_weights_->row(i);
+    weights->insert(weights->end(), line, line + columns);
   }
+}
 
-  size_t r_m_weights = m_weights_->get_rows();
-  size_t c_m_weights = m_weights_->get_columns();
-
-  for (size_t col = 0; col < c_m_weights; ++col) {
-    for (size_t row = 0; row < r_m_weights; ++row) {
-      (*m_weights_)(row, col) = (*m_weights_)(row, col) +
-                                (output_matrix_prev_layer(0, row) *
-                                 (*m_weights_delta_)(0, col) * learning_rate);
+template <typename T>
+void BasicMatrixNetwork<T>::HiddenLayer::SetWeights(
+    const std::vector<double> &weights, size_t *offset) {
+  int rows = m_weights_->get_rows();
+  int columns = m_weights_->get_columns();
+  for (int i = 0; i < rows; ++i) {
+    T *line = m_weights_->row(i);
+    for (int j = 0; j < columns; ++j) {
+      line[j] = weights[(*offset)++];
     }
   }
 }
 
-void MatrixNetwork::HiddenLayer::InstallRandomWeights() {
+template <typename T>
+void BasicMatrixNetwork<T>::HiddenLayer::CorrectWeights(
+    const S21Matrix<T> &output_matrix_prev_layer, const T &learning_rate) {
+  int batch = m_weights_delta_->get_rows();
+  if (optimizer_ != nullptr) {
+    /*---направление - средний по пакету prev^T * delta, шаг из него делает
+     * оптимизатор; матрицы одного размера, поэтому и выравнивание строк
+     * одно, веса идут одним массивом---*/
+    m_direction_->SetZero();
+    m_direction_->AddProduct(output_matrix_prev_layer, *m_weights_delta_,
+                             T(1) / batch, true, false, pool_);
+    optimizer_->Step(
+        m_weights_->data(), m_direction_->data(),
+        (size_t)m_weights_->get_rows() * m_weights_->get_stride(),
+        learning_rate);
+    return;
+  }
+  if (batch == 1) {
+    CorrectWeights(output_matrix_prev_layer, *m_weights_delta_,
+                   learning_rate);
+    return;
+  }
+
+  /*---градиенты всех примеров пакета складывает одно произведение
+   * prev^T * delta, оно прибавляется прямо к весам со средним шагом---*/
+  m_weights_->AddProduct(output_matrix_prev_layer, *m_weights_delta_,
+                         learning_rate / batch, true, false, pool_);
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::HiddenLayer::CorrectWeights(
+    const S21Matrix<T> &output_matrix_prev_layer, const S21Matrix<T> &delta,
+    const T &learning_rate) {
+  /*---размеры сверяет само выражение---*/
+  *m_weights_ += learning_rate * outer(output_matrix_prev_layer, delta);
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::HiddenLayer::ApplyGradient(
+    const S21Matrix<T> &gradient, const size_t &batch,
+    const T &learning_rate) {
+  if (optimizer_ != nullptr) {
+    *m_direction_ = (T(1) / batch) * gradient;
+    optimizer_->Step(
+        m_weights_->data(), m_direction_->data(),
+        (size_t)m_weights_->get_rows() * m_weights_->get_stride(),
+        learning_rate);
+    return;
+  }
+  *m_weights_ += (learning_rate / batch) * gradient;
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::HiddenLayer::InstallRandomWeights() {
   int rows = m_weights_->get_rows();
   int columns = m_weights_->get_columns();
 
+  /*---у ReLU и tanh разброс весов сужается по числу входов (He и Glorot),
+   * иначе сигналы растут или насыщаются от слоя к слою---*/
+  double scale = 1;
+  if (activation_ == s21_kernels::Activation::kRelu ||
+      activation_ == s21_kernels::Activation::kLeakyRelu) {
+    scale = std::sqrt(6.0 / rows);
+  } else if (activation_ == s21_kernels::Activation::kTanh) {
+    scale = std::sqrt(6.0 / (rows + columns));
+  }
+
   for (int i = 0; i < rows; ++i) {
     for (int j = 0; j < columns; ++j) {
-      (*m_weights_)(i, j) = (rand() % 201 - 100) * 0.01;
+      (*m_weights_)(i, j) = (rand() % 201 - 100) * 0.01 * scale;
     }
   }
 }
 
-void MatrixNetwork::HiddenLayer::CalcOutputMatrix(
-    const S21Matrix &output_matrix_prev_layer) {
-  if (m_output_ != nullptr) {
-    delete m_output_;
+template <typename T>
+void BasicMatrixNetwork<T>::HiddenLayer::CalcOutputMatrix(
+    const S21Matrix<T> &output_matrix_prev_layer,
+    const s21_kernels::SigmoidMode &sigmoid_mode) {
+  CalcOutputMatrix(output_matrix_prev_layer, sigmoid_mode, m_output_,
+                   active_index_.data(), active_values_.data());
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::HiddenLayer::CalcOutputMatrix(
+    const S21Matrix<T> &output_matrix_prev_layer,
+    const s21_kernels::SigmoidMode &sigmoid_mode, S21Matrix<T> *output,
+    int *active_index, T *active_values) const {
+  if (sparse_input_ &&
+      CalcOutputMatrixSparse(output_matrix_prev_layer, sigmoid_mode, output,
+                             active_index, active_values)) {
+    return;
+  }
+
+  /*---результат пишется прямо в матрицу output, без временных матриц; она
+   * перевыделяется, только если меняется число строк (размер пакета)---*/
+  if (output_matrix_prev_layer.get_rows() == 1) {
+    *output = activate(output_matrix_prev_layer * *m_weights_, activation_,
+                       sigmoid_mode);
+  } else {
+    /*---пакет умножается блочным gemm, затем активация на месте---*/
+    Multiply(output_matrix_prev_layer, *m_weights_, false, output);
+    *output = activate(*output, activation_, sigmoid_mode);
   }
-  m_output_ = new S21Matrix(output_matrix_prev_layer);
-  m_output_->MulMatrixWithSigmoid(*m_weights_);
 }
 
-void MatrixNetwork::HiddenLayer::CalcWeightsDeltaMatrix(
-    const S21Matrix &delta_matrix_prev_layer) {
-  if (m_output_ == nullptr) {
-    throw std::out_of_range("output matrix is nullptr");
+template <typename T>
+void BasicMatrixNetwork<T>::HiddenLayer::Multiply(const S21Matrix<T> &a,
+                                                  const S21Matrix<T> &b,
+                                                  const bool &transpose_b,
+                                                  S21Matrix<T> *result) const {
+  if (a.get_rows() == 1) {
+    *result = transpose_b ? a * transpose(b) : a * b;
+  } else {
+    result->Gemm(a, b, false, transpose_b, pool_);
   }
+}
 
-  if (m_weights_delta_ != nullptr) {
-    delete m_weights_delta_;
+template <typename T>
+bool BasicMatrixNetwork<T>::HiddenLayer::CalcOutputMatrixSparse(
+    const S21Matrix<T> &output_matrix_prev_layer,
+    const s21_kernels::SigmoidMode &sigmoid_mode, S21Matrix<T> *output,
+    int *active_index, T *active_values) const {
+  /*---плотный вход (и вход не того размера, ошибку для него выдаст
+   * обычное произведение) считается как обычно---*/
+  if (output_matrix_prev_layer.get_columns() != m_weights_->get_rows() ||
+      !output_matrix_prev_layer.IsSparse()) {
+    return false;
   }
-  m_weights_delta_ = new S21Matrix(1, sum_neirons_);
 
-  for (size_t j = 0; j < sum_neirons_; ++j) {
-    double sigmoid = (*m_output_)(0, j);
-    double sigmoid_dx = sigmoid * (1 - sigmoid);
-    double sum_error = 0.0;
-    for (int i = 0; i < delta_matrix_prev_layer.get_columns(); ++i) {
-      sum_error += (*m_weights_)(j, i) * delta_matrix_prev_layer(0, i);
+  /*---каждая строка входа сжимается в список ненулевых элементов, в
+   * сумму идут только их строки весов---*/
+  int rows = output_matrix_prev_layer.get_rows();
+  int columns = output_matrix_prev_layer.get_columns();
+  output->Resize(rows, m_weights_->get_columns());
+  for (int i = 0; i < rows; ++i) {
+    const T *input = output_matrix_prev_layer.row(i);
+    int active = 0;
+    for (int j = 0; j < columns; ++j) {
+      if (input[j] != 0) {
+        active_index[active] = j;
+        active_values[active] = input[j];
+        ++active;
+      }
+    }
+    if (activation_ == s21_kernels::Activation::kSigmoid) {
+      s21_kernels::GemvSparseSigmoid(
+          active_values, active_index, active, m_weights_->data(),
+          m_weights_->get_columns(), m_weights_->get_stride(), output->row(i),
+          nullptr, sigmoid_mode);
+    } else {
+      s21_kernels::GemvSparse(active_values, active_index, active,
+                              m_weights_->data(), m_weights_->get_columns(),
+                              m_weights_->get_stride(), output->row(i));
+      s21_kernels::Activate(output->row(i), output->get_columns(),
+                            activation_, sigmoid_mode);
     }
-    (*m_weights_delta_)(0, j) = sigmoid_dx * sum_error;
   }
+  return true;
 }
 
-/*----getters HiddenLayer-------*/
+template <typename T>
+void BasicMatrixNetwork<T>::HiddenLayer::CalcWeightsDeltaMatrix(
+    const S21Matrix<T> &delta_matrix_next_layer,
+    const S21Matrix<T> &weights_next_layer) {
+  CalcWeightsDeltaMatrix(*m_output_, delta_matrix_next_layer,
+                         weights_next_layer, m_weights_delta_);
+}
 
-const S21Matrix &MatrixNetwork::HiddenLayer::get_output_matrix() {
-  if (m_output_ == nullptr) {
-    throw std::invalid_argument("can't get output matrix, is nullptr");
+template <typename T>
+void BasicMatrixNetwork<T>::HiddenLayer::CalcWeightsDeltaMatrix(
+    const S21Matrix<T> &output, const S21Matrix<T> &delta_matrix_next_layer,
+    const S21Matrix<T> &weights_next_layer, S21Matrix<T> *delta) const {
+  /*---ошибка нейрона - сумма дельт следующего слоя, взвешенная весами его
+   * связей с этим нейроном; для пакета это одно произведение gemm---*/
+  Multiply(delta_matrix_next_layer, weights_next_layer, true, delta);
+
+  /*---и умножается на производную функции активации, выраженную через
+   * сигналы слоя---*/
+  int rows = delta->get_rows();
+  for (int i = 0; i < rows; ++i) {
+    s21_kernels::ActivationDerivative(output.row(i), delta->row(i),
+                                      delta->get_columns(), activation_);
   }
+}
+
+/*----getters HiddenLayer-------*/
+
+template <typename T>
+const S21Matrix<T> &BasicMatrixNetwork<T>::HiddenLayer::get_output_matrix() {
   return *m_output_;
 }
 
-const S21Matrix &MatrixNetwork::HiddenLayer::get_weights_delta_matrix() {
-  if (m_weights_delta_ == nullptr) {
-    throw std::invalid_argument("can't get delta matrix, is nullptr");
-  }
+template <typename T>
+const S21Matrix<T> &BasicMatrixNetwork<T>::HiddenLayer::get_weights_matrix() {
+  return *m_weights_;
+}
+
+template <typename T>
+const S21Matrix<T>
+    &BasicMatrixNetwork<T>::HiddenLayer::get_weights_delta_matrix() {
   return *m_weights_delta_;
 }
 
-const size_t &MatrixNetwork::HiddenLayer::get_sum_neirons() {
+template <typename T>
+const size_t &BasicMatrixNetwork<T>::HiddenLayer::get_sum_neirons() {
   return sum_neirons_;
 }
 
 /*-----print functions-----*/
 
-void MatrixNetwork::HiddenLayer::print_weghts() {
+template <typename T>
+void BasicMatrixNetwork<T>::HiddenLayer::print_weghts() {
   std::cout << "----weights----\n";
   for (int i = 0; i < m_weights_->get_rows(); ++i) {
     for (int j = 0; j < m_weights_->get_columns(); ++j) {
@@ -353,7 +1046,8 @@ void MatrixNetwork::HiddenLayer::print_weghts() {
   std::cout << "----weights----\n\n";
 }
 
-void MatrixNetwork::HiddenLayer::print_output_values() {
+template <typename T>
+void BasicMatrixNetwork<T>::HiddenLayer::print_output_values() {
   std::cout << "----Signals neirons----" << std::endl;
   for (int i = 0; i < m_output_->get_rows(); ++i) {
     for (int j = 0; j < m_output_->get_columns(); ++j) {
@@ -363,7 +1057,8 @@ void MatrixNetwork::HiddenLayer::print_output_values() {
   std::cout << "----Signals neirons----\n\n" << std::endl;
 }
 
-void MatrixNetwork::HiddenLayer::print_weights_delta() {
+template <typename T>
+void BasicMatrixNetwork<T>::HiddenLayer::print_weights_delta() {
   std::cout << "----delta----" << std::endl;
   for (int i = 0; i < m_weights_delta_->get_rows(); ++i) {
     for (int j = 0; j < m_weights_delta_->get_columns(); ++j) {
@@ -377,52 +1072,121 @@ void MatrixNetwork::HiddenLayer::print_weights_delta() {
 
 /*––––––––––– class OutputLayer –––––––––––––––––*/
 
-MatrixNetwork::OutputLayer::OutputLayer(const unsigned &rows_weight_layer,
-                                        const unsigned &cols_weight_layer)
-    : MatrixNetwork::HiddenLayer::HiddenLayer(rows_weight_layer,
-                                              cols_weight_layer) {}
+template <typename T>
+BasicMatrixNetwork<T>::OutputLayer::OutputLayer(
+    const unsigned &rows_weight_layer, const unsigned &cols_weight_layer)
+    : HiddenLayer(rows_weight_layer, cols_weight_layer),
+      expected_value_(0),
+      target_(1, cols_weight_layer),
+      output_type_(OutputType::kSigmoid) {}
+
+template <typename T>
+void BasicMatrixNetwork<T>::OutputLayer::CalcOutputMatrix(
+    const S21Matrix<T> &output_matrix_prev_layer,
+    const s21_kernels::SigmoidMode &sigmoid_mode) {
+  CalcOutputMatrix(output_matrix_prev_layer, sigmoid_mode, this->m_output_,
+                   nullptr, nullptr);
+}
 
-void MatrixNetwork::OutputLayer::CalcWeightsDeltaMatrix() {
-  if (this->m_output_ == nullptr) {
-    throw std::out_of_range("output matrix is nullptr");
+template <typename T>
+void BasicMatrixNetwork<T>::OutputLayer::CalcOutputMatrix(
+    const S21Matrix<T> &output_matrix_prev_layer,
+    const s21_kernels::SigmoidMode &sigmoid_mode, S21Matrix<T> *output,
+    int *active_index, T *active_values) const {
+  if (output_type_ == OutputType::kSigmoid) {
+    HiddenLayer::CalcOutputMatrix(output_matrix_prev_layer, sigmoid_mode,
+                                  output, active_index, active_values);
+    return;
   }
 
-  if (this->m_weights_delta_ != nullptr) {
-    delete this->m_weights_delta_;
+  /*---сначала линейные выходы всех строк одним произведением, затем
+   * softmax каждой строки---*/
+  this->Multiply(output_matrix_prev_layer, *this->m_weights_, false, output);
+  int rows = output->get_rows();
+  for (int i = 0; i < rows; ++i) {
+    s21_kernels::Softmax(output->row(i), output->get_columns(),
+                         sigmoid_mode);
   }
-  this->m_weights_delta_ = new S21Matrix(1, this->sum_neirons_);
+}
 
-  for (size_t j = 0; j < this->sum_neirons_; ++j) {
-    double sigmoid = (*this->m_output_)(0, j);
-    double sigmoid_dx = sigmoid * (1 - sigmoid);
-    if (j + 1 == expected_value_) {
-      (*m_weights_delta_)(0, j) = (1.0 - sigmoid) * sigmoid_dx;
-    } else {
-      (*m_weights_delta_)(0, j) = (0.0 - sigmoid) * sigmoid_dx;
-    }
+template <typename T>
+void BasicMatrixNetwork<T>::OutputLayer::CalcWeightsDeltaMatrix() {
+  CalcWeightsDeltaMatrix(*this->m_output_, target_, this->m_weights_delta_);
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::OutputLayer::CalcWeightsDeltaMatrix(
+    const S21Matrix<T> &output, const S21Matrix<T> &target,
+    S21Matrix<T> *delta) const {
+  if (output_type_ == OutputType::kSoftmax) {
+    /*---производная перекрестной энтропии по входам softmax---*/
+    *delta = target - output;
+    return;
   }
+  *delta = hadamard(sigmoid_derivative(output), target - output);
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::OutputLayer::set_output_type(
+    const OutputType &type) {
+  output_type_ = type;
 }
 
-void MatrixNetwork::OutputLayer::set_expected_value(const size_t &value) {
+template <typename T>
+const OutputType &BasicMatrixNetwork<T>::OutputLayer::get_output_type()
+    const {
+  return output_type_;
+}
+
+template <typename T>
+void BasicMatrixNetwork<T>::OutputLayer::set_expected_value(
+    const size_t &value) {
   expected_value_ = value;
+  target_.Resize(1, this->sum_neirons_);
+  SetTargetRow(value, 0, &target_);
 }
 
-const size_t &MatrixNetwork::OutputLayer::get_expected_value() {
-  return expected_value_;
+template <typename T>
+void BasicMatrixNetwork<T>::OutputLayer::set_expected_values(
+    const std::vector<size_t> &values, const size_t &first,
+    const size_t &count) {
+  target_.Resize(count, this->sum_neirons_);
+  for (size_t i = 0; i < count; ++i) {
+    SetTargetRow(values[first + i], i, &target_);
+  }
 }
 
-size_t MatrixNetwork::OutputLayer::ResultNeiron() {
-  if (this->m_output_ == nullptr) {
-    throw std::out_of_range(
-        "Error int resultNeiron(), outputMatrix is nullptr");
+template <typename T>
+void BasicMatrixNetwork<T>::OutputLayer::SetTargetRow(
+    const size_t &value, const int &row, S21Matrix<T> *target_matrix) {
+  /*---ответы нумеруются с единицы, у нейрона ответа цель 1, у остальных 0---*/
+  S21VectorView<T> target = target_matrix->row_view(row);
+  for (int j = 0; j < target.size(); ++j) {
+    target[j] = ((size_t)j + 1 == value) ? 1 : 0;
   }
-  std::pair<double, size_t> result{(*m_output_)(0, 0), 0};
+}
+
+template <typename T>
+const size_t &BasicMatrixNetwork<T>::OutputLayer::get_expected_value() {
+  return expected_value_;
+}
+
+template <typename T>
+size_t BasicMatrixNetwork<T>::OutputLayer::ResultNeiron(const int &row) {
+  return ResultNeiron(*this->m_output_, row);
+}
 
-  /*---матрица значений состоит только из одной строки---*/
-  int columns = m_output_->get_columns();
+template <typename T>
+size_t BasicMatrixNetwork<T>::OutputLayer::ResultNeiron(
+    const S21Matrix<T> &output_matrix, const int &row) {
+  /*---у пакета своя строка значений для каждого изображения---*/
+  S21VectorView<const T> output = output_matrix.row_view(row);
+  std::pair<T, size_t> result{output[0], 0};
+
+  int columns = output.size();
   for (int j = 0; j < columns; ++j) {
-    if (result.first < (*m_output_)(0, j)) {
-      result.first = (*m_output_)(0, j);
+    if (result.first < output[j]) {
+      result.first = output[j];
       result.second = j;
     }
   }
@@ -433,4 +1197,26 @@ size_t MatrixNetwork::OutputLayer::ResultNeiron() {
 
 /*–––––––––––––––––––––––––––––––––––––––––––––––--*/
 
+/*––––––––––– class Workspace –––––––––––––––––––*/
+
+template <typename T>
+BasicMatrixNetwork<T>::Workspace::Workspace(const size_t &sum_hidden_layers)
+    : input(1, kInputLayer),
+      target(1, kSumNeironsOutputLayer),
+      active_index(kInputLayer),
+      active_values(kInputLayer) {
+  outputs.reserve(sum_hidden_layers + 1);
+  for (size_t i = 0; i < sum_hidden_layers; ++i) {
+    outputs.emplace_back(1, kSumNeironsHiddenLayer);
+  }
+  outputs.emplace_back(1, kSumNeironsOutputLayer);
+  deltas = outputs;
+}
+
+/*–––––––––––––––––––––––––––––––––––––––––––––––--*/
+
+/*---сеть собирается только для этих двух типов---*/
+template class BasicMatrixNetwork<float>;
+template class BasicMatrixNetwork<double>;
+
 }  // namespace s21_network
@@ -2,53 +2,201 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
 #include <cmath>
 #include <ctime>
 #include <fstream>
 #include <iostream>
 #include <limits>
+#include <type_traits>
 
+#include "computeBackend.hpp"
 #include "interfaceNetwork.hpp"
 #include "s21_matrix_oop.h"
 
 namespace s21_network {
 
+/* type of the elements of weights and activations in MatrixNetwork */
+enum ScalarType { kDouble, kFloat };
+
 class MatrixNetwork : public InterfaceNetwork {
  public:
-  MatrixNetwork(const int &sum_hidden_layers, const double &learning_rate);
-  virtual ~MatrixNetwork();
+  /*---создает сеть, которая хранит веса и сигналы в float или double---*/
+  static MatrixNetwork *Create(const int &sum_hidden_layers,
+                               const double &learning_rate,
+                               const ScalarType &scalar_type = kDouble);
+  virtual ~MatrixNetwork() {}
+
+  virtual ScalarType get_scalar_type() const = 0;
+
+  /*---обучение пакетами: примеры идут через сеть по batch_size строк
+   * сразу, на каждый пакет одна коррекция весов со средним шагом по его
+   * примерам; последний пакет может быть меньше---*/
+  virtual void LearnBatch(const std::vector<std::vector<unsigned>> &samples,
+                          const std::vector<size_t> &labels,
+                          const size_t &batch_size) = 0;
+
+  /*---синхронное обучение пакетом в нескольких потоках. AccumulateGradient
+   * пишет в workspace сумму градиентов примеров [first, first + count)
+   * пакета, веса не меняются, поэтому потоки со своими workspace считают
+   * свои части пакета одновременно. AddGradient прибавляет сумму source к
+   * сумме target, ApplyGradient делает по сумме workspace один шаг со
+   * средним по sum_samples примерам, как LearnBatch---*/
+  virtual void AccumulateGradient(
+      const std::vector<std::vector<unsigned>> &samples,
+      const std::vector<size_t> &labels, const size_t &first,
+      const size_t &count, InferenceWorkspace *workspace) const = 0;
+  virtual void AddGradient(InferenceWorkspace *source,
+                           InferenceWorkspace *target) const = 0;
+  virtual void ApplyGradient(InferenceWorkspace *workspace,
+                             const size_t &sum_samples) = 0;
+
+  /*---набор вычислительных ядер, можно сменить в любой момент, бросает
+   * std::invalid_argument, если бэкенд не собран---*/
+  virtual void set_backend(const s21_kernels::BackendType &backend) = 0;
+  virtual s21_kernels::BackendType get_backend() const = 0;
+
+  /*---пул, на потоках которого делятся произведения матриц пакетов;
+   * nullptr - все считает вызывающий поток. Пул сеть не удаляет, он должен
+   * жить, пока сеть им пользуется---*/
+  virtual void set_thread_pool(ThreadPool *pool) = 0;
+  virtual ThreadPool *get_thread_pool() const = 0;
+};
+
+template <typename T>
+class BasicMatrixNetwork : public MatrixNetwork {
+ public:
+  BasicMatrixNetwork(const int &sum_hidden_layers,
+                     const double &learning_rate);
+  virtual ~BasicMatrixNetwork();
 
   void InstallRandomWeights() override;
+  void InstallRandomWeights(const unsigned &seed) override;
   void LoadWeights(const std::string &filename) override;
   void SaveWeights(const std::string &filename) override;
+  std::vector<double> GetWeights() const override;
+  void SetWeights(const std::vector<double> &weights) override;
   size_t Prediction(const std::vector<unsigned> &input_layer) override;
+  void PredictBatch(const uint8_t *pixels, const size_t &n,
+                    size_t *out_labels) override;
+  InferenceWorkspace *CreateWorkspace() const override;
+  size_t Prediction(const std::vector<unsigned> &input_layer,
+                    InferenceWorkspace *workspace) const override;
+  void PredictBatch(const uint8_t *pixels, const size_t &n,
+                    size_t *out_labels,
+                    InferenceWorkspace *workspace) const override;
   void LearnNetwork(const std::vector<unsigned> &input_layer,
                     const size_t &expectedValue) override;
+  void LearnNetwork(const std::vector<unsigned> &input_layer,
+                    const size_t &expected_value,
+                    InferenceWorkspace *workspace) override;
+  void LearnBatch(const std::vector<std::vector<unsigned>> &samples,
+                  const std::vector<size_t> &labels,
+                  const size_t &batch_size) override;
+  void AccumulateGradient(const std::vector<std::vector<unsigned>> &samples,
+                          const std::vector<size_t> &labels,
+                          const size_t &first, const size_t &count,
+                          InferenceWorkspace *workspace) const override;
+  void AddGradient(InferenceWorkspace *source,
+                   InferenceWorkspace *target) const override;
+  void ApplyGradient(InferenceWorkspace *workspace,
+                     const size_t &sum_samples) override;
+  void PredictProbabilities(const std::vector<unsigned> &input_layer,
+                            std::vector<double> *probabilities) override;
+  void set_output_type(const OutputType &type) override;
+  OutputType get_output_type() const override;
+  void set_activation(const size_t &layer,
+                      const s21_kernels::Activation &activation) override;
+  s21_kernels::Activation get_activation(const size_t &layer) const override;
+  ScalarType get_scalar_type() const override;
+  void set_sigmoid_mode(const s21_kernels::SigmoidMode &mode) override;
+  s21_kernels::SigmoidMode get_sigmoid_mode() const override;
+  void set_optimizer(const OptimizerConfig &config) override;
+  OptimizerConfig get_optimizer() const override;
+  void set_learning_rate(const double &learning_rate) override;
+  double get_learning_rate() const override;
+  void set_backend(const s21_kernels::BackendType &backend) override;
+  s21_kernels::BackendType get_backend() const override;
+  void set_thread_pool(ThreadPool *pool) override;
+  ThreadPool *get_thread_pool() const override;
+  InterfaceNetwork *Clone() const override;
   void FeedForward(const std::vector<unsigned> &input_layer);
 
  protected:
   void set_input_layer(const std::vector<unsigned> &input_layer);
+  void set_input_layer(const std::vector<std::vector<unsigned>> &samples,
+                       const size_t &first, const size_t &count);
+  /*---пишут сигналы входного слоя в строки матрицы input---*/
+  static void SetInputRow(const std::vector<unsigned> &input_layer,
+                          const int &row, S21Matrix<T> *input);
+  static void SetInputRows(const uint8_t *pixels, const size_t &count,
+                           S21Matrix<T> *input);
+  void FeedForwardInputLayer();
   void CorrectWeights();
+  void CheckHiddenLayer(const size_t &layer) const;
 
  private:
+  class Workspace;
+  Workspace *CheckWorkspace(InferenceWorkspace *workspace) const;
+  /*---прямой проход по входу workspace, сама сеть не меняется---*/
+  void FeedForwardWorkspace(Workspace *workspace) const;
+  /*---дельты слоев по сигналам и цели workspace, пишутся в нее же---*/
+  void CalcDeltasWorkspace(Workspace *workspace) const;
+  /*---обратный проход по workspace, меняются только веса---*/
+  void CorrectWeightsWorkspace(Workspace *workspace);
+
   class HiddenLayer {
    public:
+    /*---sparse_input - вход слоя в основном нулевой (пиксели), тогда
+     * строки весов нулевых входов не читаются---*/
     HiddenLayer(const unsigned &rows_weights_matrix,
-                const unsigned &columns_weights_matrix);
+                const unsigned &columns_weights_matrix,
+                const bool &sparse_input = false);
     ~HiddenLayer();
 
     void LoadWeights(std::ifstream *stream);
     void SaveWeights(std::ofstream *stream);
-    void CorrectWeights(const S21Matrix &output_matrix_prev_layer,
-                        const double &learning_rate);
+    /*---дописывают веса слоя в конец вектора и читают их с *offset---*/
+    void GetWeights(std::vector<double> *weights) const;
+    void SetWeights(const std::vector<double> &weights, size_t *offset);
+    void CorrectWeights(const S21Matrix<T> &output_matrix_prev_layer,
+                        const T &learning_rate);
+    /*---простой шаг по одному примеру с чужой дельтой delta, оптимизатор
+     * слоя не участвует---*/
+    void CorrectWeights(const S21Matrix<T> &output_matrix_prev_layer,
+                        const S21Matrix<T> &delta, const T &learning_rate);
+    /*---шаг по сумме градиентов gradient batch примеров, той же формы, что
+     * и веса: средний, как у пакета в CorrectWeights---*/
+    void ApplyGradient(const S21Matrix<T> &gradient, const size_t &batch,
+                       const T &learning_rate);
     void InstallRandomWeights();
+    /*---nullptr - простой шаг, слой забирает оптимизатор себе---*/
+    void set_optimizer(Optimizer<T> *optimizer);
+    void set_activation(const s21_kernels::Activation &activation);
+    const s21_kernels::Activation &get_activation() const;
+    void set_thread_pool(ThreadPool *pool);
 
-    void CalcOutputMatrix(const S21Matrix &output_matrix_prev_layer);
-    void CalcWeightsDeltaMatrix(const S21Matrix &delta_matrix_prev_layer);
+    void CalcOutputMatrix(const S21Matrix<T> &output_matrix_prev_layer,
+                          const s21_kernels::SigmoidMode &sigmoid_mode);
+    /*---то же в чужую матрицу output, слой не меняется; active_index и
+     * active_values - буферы на число строк весов, нужны только слою с
+     * разреженным входом---*/
+    void CalcOutputMatrix(const S21Matrix<T> &output_matrix_prev_layer,
+                          const s21_kernels::SigmoidMode &sigmoid_mode,
+                          S21Matrix<T> *output, int *active_index,
+                          T *active_values) const;
+    void CalcWeightsDeltaMatrix(const S21Matrix<T> &delta_matrix_next_layer,
+                                const S21Matrix<T> &weights_next_layer);
+    /*---то же по сигналам слоя output в чужую матрицу delta---*/
+    void CalcWeightsDeltaMatrix(const S21Matrix<T> &output,
+                                const S21Matrix<T> &delta_matrix_next_layer,
+                                const S21Matrix<T> &weights_next_layer,
+                                S21Matrix<T> *delta) const;
 
     /*----getters HiddenLayer-------*/
-    const S21Matrix &get_output_matrix();
-    const S21Matrix &get_weights_delta_matrix();
+    const S21Matrix<T> &get_output_matrix();
+    const S21Matrix<T> &get_weights_matrix();
+    const S21Matrix<T> &get_weights_delta_matrix();
     const size_t &get_sum_neirons();
 
     /*-----print functions-----*/
@@ -58,10 +206,26 @@ class MatrixNetwork : public InterfaceNetwork {
     /*------------------------*/
 
    protected:
-    S21Matrix *m_output_;   // матрица значений нейронов
-    S21Matrix *m_weights_;  // матрица весов
-    S21Matrix *m_weights_delta_;
+    /*---result = a * b или a * b^T: строка считается векторным ядром,
+     * пакет - блочным gemm на пуле сети---*/
+    void Multiply(const S21Matrix<T> &a, const S21Matrix<T> &b,
+                  const bool &transpose_b, S21Matrix<T> *result) const;
+    bool CalcOutputMatrixSparse(const S21Matrix<T> &output_matrix_prev_layer,
+                                const s21_kernels::SigmoidMode &sigmoid_mode,
+                                S21Matrix<T> *output, int *active_index,
+                                T *active_values) const;
+
+    S21Matrix<T> *m_output_;   // матрица значений нейронов
+    S21Matrix<T> *m_weights_;  // матрица весов
+    S21Matrix<T> *m_weights_delta_;
+    Optimizer<T> *optimizer_;    // nullptr - простой шаг
+    S21Matrix<T> *m_direction_;  // направление шага для оптимизатора
     size_t sum_neirons_;  // количество нейронов в скрытых слоях
+    bool sparse_input_;
+    s21_kernels::Activation activation_;
+    std::vector<int> active_index_;  // номера ненулевых входов строки
+    std::vector<T> active_values_;   // и их значения
+    ThreadPool *pool_;               // пул сети для gemm пакетов
   };
 
   class OutputLayer : public HiddenLayer {
@@ -69,24 +233,75 @@ class MatrixNetwork : public InterfaceNetwork {
     OutputLayer(const unsigned &rows_weight_layer,
                 const unsigned &cols_weight_layer);
 
+    /*---скрывают версии HiddenLayer: у выхода kSoftmax вместо сигмоиды
+     * нормировка каждой строки---*/
+    void CalcOutputMatrix(const S21Matrix<T> &output_matrix_prev_layer,
+                          const s21_kernels::SigmoidMode &sigmoid_mode);
+    void CalcOutputMatrix(const S21Matrix<T> &output_matrix_prev_layer,
+                          const s21_kernels::SigmoidMode &sigmoid_mode,
+                          S21Matrix<T> *output, int *active_index,
+                          T *active_values) const;
     void CalcWeightsDeltaMatrix();
-    void CalcWeightsDeltaMatrix(const S21Matrix &delta_matrix_prevLayer) =
+    /*---то же по сигналам output и цели target в чужую матрицу delta---*/
+    void CalcWeightsDeltaMatrix(const S21Matrix<T> &output,
+                                const S21Matrix<T> &target,
+                                S21Matrix<T> *delta) const;
+    void CalcWeightsDeltaMatrix(const S21Matrix<T> &delta_matrix_next_layer,
+                                const S21Matrix<T> &weights_next_layer) =
         delete;
 
+    void set_output_type(const OutputType &type);
+    const OutputType &get_output_type() const;
+
     void set_expected_value(const size_t &value);
+    void set_expected_values(const std::vector<size_t> &values,
+                             const size_t &first, const size_t &count);
     const size_t &get_expected_value();
 
-    size_t ResultNeiron();
+    size_t ResultNeiron(const int &row = 0);
+    /*---ответ по строке row любой матрицы сигналов выходного слоя---*/
+    static size_t ResultNeiron(const S21Matrix<T> &output, const int &row);
+    /*---цель ответа value в строке row матрицы target---*/
+    static void SetTargetRow(const size_t &value, const int &row,
+                             S21Matrix<T> *target);
 
    private:
     size_t expected_value_;  // ожидаемое значение
+    S21Matrix<T> target_;    // ожидаемые сигналы нейронов
+    OutputType output_type_;
   };
 
  private:
-  S21Matrix *input_layer_;                    // входной слой
+  S21Matrix<T> *input_layer_;                 // входной слой
   std::vector<HiddenLayer *> hidden_layers_;  // скрытые слои
   OutputLayer *output_layer_;                 // выходной слой
-  double learning_rate_;  // коэффициент скорости обучения
+  T learning_rate_;  // коэффициент скорости обучения
+  OptimizerConfig optimizer_config_;
+  /*---PredictBatch пропускает через сеть не больше стольких изображений
+   * за раз, чтобы матрицы слоев не росли вместе с пакетом---*/
+  static constexpr size_t kPredictBatchRows = 256;
+  s21_kernels::SigmoidMode sigmoid_mode_ = s21_kernels::SigmoidMode::kPrecise;
+  s21_kernels::BackendType backend_ = s21_kernels::BackendType::kSimd;
+  ThreadPool *pool_ = nullptr;
+};
+
+/*---рабочая память константного распознавания: своя матрица входа,
+ * матрицы сигналов всех слоев и буферы разреженного входа первого слоя;
+ * для обучения еще дельты слоев и цель---*/
+template <typename T>
+class BasicMatrixNetwork<T>::Workspace : public InferenceWorkspace {
+ public:
+  explicit Workspace(const size_t &sum_hidden_layers);
+
+  S21Matrix<T> input;
+  std::vector<S21Matrix<T>> outputs;  // скрытые слои, затем выходной
+  std::vector<S21Matrix<T>> deltas;   // в том же порядке
+  /*---суммы prev^T * delta слоев в том же порядке, пусто, пока сеть не
+   * считала в эту workspace градиент---*/
+  std::vector<S21Matrix<T>> gradients;
+  S21Matrix<T> target;
+  std::vector<int> active_index;
+  std::vector<T> active_values;
 };
 
 }  // namespace s21_network
@@ -1,12 +1,16 @@
 #include "network.hpp"
 
+#include <chrono>
+#include <cmath>
+
 namespace s21_network {
 
-Network::Network(const double &learning_rate) {
+Network::Network(const double &learning_rate, const ScalarType &scalar_type) {
   for (int hidden_layers = SumHiddenLayers::TwoHids;
        hidden_layers < SumHiddenLayers::N; ++hidden_layers) {
     /*---добавляем матричную сеть---*/
-    matrix_network_.push_back(new MatrixNetwork(hidden_layers, learning_rate));
+    matrix_network_.push_back(
+        MatrixNetwork::Create(hidden_layers, learning_rate, scalar_type));
     /*---устанавливаем случайные значения весов для матричной сети---*/
     matrix_network_.back()->InstallRandomWeights();
 
@@ -14,13 +18,23 @@ Network::Network(const double &learning_rate) {
     graph_network_.push_back(new GraphNetwork(hidden_layers, kLearningRate));
     /*---устанавливаем случайные значения весов графовой для сети---*/
     graph_network_.back()->InstallRandomWeights();
+
+    /*---и фиксированную сеть той же топологии---*/
+    fixed_network_.push_back(
+        CreateFixedNetwork(hidden_layers, learning_rate, scalar_type));
+    fixed_network_.back()->InstallRandomWeights();
   }
 
   /*---по умолчанию текущая сеть является матричной двухслойной---*/
   current_network_ = matrix_network_.front();
+  current_matrix_network_ = matrix_network_.front();
+  pool_ = new ThreadPool();
+  /*---произведения слоев матричных сетей делятся на том же пуле---*/
+  for (auto network : matrix_network_) network->set_thread_pool(pool_);
 }
 
 Network::~Network() {
+  delete pool_;
   size_t size_matrixN = matrix_network_.size();
   for (size_t i = 0; i < size_matrixN; ++i) {
     delete matrix_network_[i];
@@ -29,140 +43,362 @@ Network::~Network() {
   for (size_t i = 0; i < size_graphN; ++i) {
     delete graph_network_[i];
   }
+  for (size_t i = 0; i < fixed_network_.size(); ++i) {
+    delete fixed_network_[i];
+  }
 }
 
 void Network::LoadWeightsFromFile(const std::string &filename,
                                   const int &index_network) {
   if (index_network < 0 || (size_t)index_network >= matrix_network_.size() ||
-      (size_t)index_network >= graph_network_.size()) {
+      (size_t)index_network >= graph_network_.size() ||
+      (size_t)index_network >= fixed_network_.size()) {
     throw std::out_of_range("Error, index Network out of range");
   }
   matrix_network_[index_network]->LoadWeights(filename);
   graph_network_[index_network]->LoadWeights(filename);
+  fixed_network_[index_network]->LoadWeights(filename);
 }
 
 void Network::SaveWeightsToFile(const std::string &filename) {
   current_network_->SaveWeights(filename);
 }
 
-std::vector<double> Network::StartLearnNetwork(const std::string &train_file,
-                                               const int &sum_epoch,
-                                               const bool &continue_learn,
-                                               const std::string &test_file) {
+std::vector<double> Network::StartLearnNetwork(
+    const std::string &train_file, const int &sum_epoch,
+    const bool &continue_learn, const std::string &test_file,
+    const size_t &batch_size, const LearningSchedule &schedule) {
   if (sum_epoch < 1) {
     throw std::invalid_argument("Error in startLearnNetwork(), sumEpoch < 1");
   }
+  if (batch_size < 1) {
+    throw std::invalid_argument("Error in startLearnNetwork(), batchSize < 1");
+  }
+  CheckSchedule(schedule, test_file);
+  size_t learn_threads = ThreadsOrPool(learn_threads_);
+  bool hogwild = learn_threads > 1 && batch_size == 1;
+  bool data_parallel = learn_threads > 1 && batch_size > 1;
+  if (data_parallel && current_matrix_network_ == nullptr) {
+    throw std::invalid_argument(
+        "Error in startLearnNetwork(), parallel batches need matrix network");
+  }
+  if (hogwild &&
+      current_network_->get_optimizer().type != OptimizerType::kSgd) {
+    throw std::invalid_argument(
+        "Error in startLearnNetwork(), hogwild learning needs SGD step");
+  }
+  learn_speed_ = LearnSpeed();
+  learn_speed_.threads = learn_threads;
+  bool learn_batches = batch_size > 1 && current_matrix_network_ != nullptr;
+  std::vector<std::vector<unsigned>> batch_samples{};
+  std::vector<size_t> batch_labels{};
+  std::vector<std::unique_ptr<InferenceWorkspace>> workspaces{};
+  for (size_t t = 0; data_parallel && t < learn_threads; ++t) {
+    workspaces.emplace_back(current_network_->CreateWorkspace());
+  }
+  std::vector<std::string> batch_lines{};
+  auto learn_batch = [&]() {
+    if (data_parallel) {
+      ParseLines(batch_lines, &batch_samples, &batch_labels);
+      batch_lines.clear();
+      LearnBatchParallel(batch_samples, batch_labels, workspaces);
+    } else {
+      current_matrix_network_->LearnBatch(batch_samples, batch_labels,
+                                          batch_size);
+    }
+    batch_samples.clear();
+    batch_labels.clear();
+  };
   std::vector<double> res{};
+  /*---веса лучшей эпохи для ранней остановки---*/
+  std::vector<double> best_weights{};
+  double best_accuracy = 0;
+  int stale_epochs = 0;
+  double base_rate = current_network_->get_learning_rate();
   /*---устанавливаем случайные значения весов для сети, если обучение начинается
    * с нуля---*/
   if (continue_learn == false) {
-    current_network_->InstallRandomWeights();
+    InstallRandomWeights();
   }
 
-  /*---запускаем оубчение на отведенное количество эпох---*/
-  for (int i = 0; i < sum_epoch; ++i) {
-    std::ifstream stream(train_file);
-    if (stream.is_open()) {
-      setlocale(LC_ALL, "en_US.UTF-8");
-      while (!stream.eof()) {
-        std::string line{};
-        std::getline(stream, line);
-        if (!line.empty()) {
-          std::vector<unsigned> input_values;
-          size_t expected_value{};
-          ReadLineFromFileWithPixels(line, &expected_value, &input_values);
-          /*---запуск обучения текущей сети, выбранной из интерфейса---*/
-          //          if (pixels.size() == 784)
-          current_network_->LearnNetwork(input_values, expected_value);
+  /*---скорость обучения из расписания не должна остаться в сети, даже если
+   * эпоха прервана исключением---*/
+  try {
+    /*---запускаем оубчение на отведенное количество эпох---*/
+    for (int i = 0; i < sum_epoch; ++i) {
+      current_network_->set_learning_rate(
+          ScheduledLearningRate(schedule, base_rate, i, sum_epoch));
+      auto epoch_start = std::chrono::steady_clock::now();
+      if (hogwild) {
+        learn_speed_.samples += LearnEpochHogwild(train_file, learn_threads);
+      } else {
+        std::ifstream stream(train_file);
+        if (stream.is_open()) {
+          setlocale(LC_ALL, "en_US.UTF-8");
+          while (!stream.eof()) {
+            std::string line{};
+            std::getline(stream, line);
+            if (!line.empty() && data_parallel) {
+              /*---строки пакета разбирают потоки пула в learn_batch---*/
+              ++learn_speed_.samples;
+              batch_lines.push_back(std::move(line));
+              if (batch_lines.size() == batch_size) {
+                learn_batch();
+              }
+            } else if (!line.empty()) {
+              std::vector<unsigned> input_values;
+              size_t expected_value{};
+              ReadLineFromFileWithPixels(line, &expected_value, &input_values);
+              ++learn_speed_.samples;
+              /*---запуск обучения текущей сети, выбранной из интерфейса---*/
+              //          if (pixels.size() == 784)
+              if (learn_batches) {
+                batch_samples.push_back(std::move(input_values));
+                batch_labels.push_back(expected_value);
+                if (batch_samples.size() == batch_size) {
+                  learn_batch();
+                }
+              } else {
+                current_network_->LearnNetwork(input_values, expected_value);
+              }
+            }
+          }
+          /*---неполный пакет в конце файла---*/
+          if (!batch_samples.empty() || !batch_lines.empty()) {
+            learn_batch();
+          }
+          stream.close();
+        }
+      }
+      std::chrono::duration<double> epoch_time =
+          std::chrono::steady_clock::now() - epoch_start;
+      learn_speed_.seconds += epoch_time.count();
+      if (test_file.size() && sum_epoch > 1) {
+        auto reply = StartTestNetwork(test_file);
+        double accuracy = (double)reply.second / (double)reply.first;
+        res.push_back(accuracy);
+        if (schedule.patience > 0) {
+          if (best_weights.empty() ||
+              accuracy > best_accuracy + schedule.min_delta) {
+            best_accuracy = accuracy;
+            best_weights = current_network_->GetWeights();
+            stale_epochs = 0;
+          } else if (++stale_epochs >= schedule.patience) {
+            break;
+          }
         }
       }
-      stream.close();
     }
-    if (test_file.size() && sum_epoch > 1) {
-      auto reply = StartTestNetwork(test_file);
-      res.push_back((double)reply.second / (double)reply.first);
+    /*---после ранней остановки или если последние эпохи ухудшили
+     * точность, возвращаем веса лучшей эпохи---*/
+    if (!best_weights.empty() && res.back() < best_accuracy) {
+      current_network_->SetWeights(best_weights);
     }
+  } catch (...) {
+    current_network_->set_learning_rate(base_rate);
+    throw;
+  }
+  current_network_->set_learning_rate(base_rate);
+  if (learn_speed_.seconds > 0) {
+    learn_speed_.samples_per_second =
+        learn_speed_.samples / learn_speed_.seconds;
   }
   return res;
 }
 
-std::vector<double> Network::StartCVLearn(const std::string &train_file,
-                                          const unsigned coef,
-                                          const bool &continue_learn) {
-  std::vector<double> res{};
-  if (continue_learn == false) current_network_->InstallRandomWeights();
+size_t Network::LearnEpochHogwild(const std::string &train_file,
+                                  const size_t &threads) {
+  size_t samples = 0;
+  std::vector<std::unique_ptr<InferenceWorkspace>> workspaces{};
+  for (size_t t = 0; t < threads; ++t) {
+    workspaces.emplace_back(current_network_->CreateWorkspace());
+  }
 
-  for (unsigned i{}; i < coef; i++) {
-    size_t correct_pr{}, all_pr{};
-    std::ifstream stream(train_file);
-    if (stream.is_open()) {
-      setlocale(LC_ALL, "en_US.UTF-8");
-      unsigned line_index{};
-      std::string line{};
-      while (!stream.eof()) {
-        std::getline(stream, line);
+  std::ifstream stream(train_file);
+  if (stream.is_open()) {
+    setlocale(LC_ALL, "en_US.UTF-8");
+    size_t portion = threads * kHogwildPortionSize;
+    std::vector<std::string> lines{};
+    std::string line{};
+    while (stream) {
+      lines.clear();
+      while (lines.size() < portion && std::getline(stream, line)) {
         if (!line.empty()) {
-          if (line_index != i) {
-            std::vector<unsigned> input_values{};
-            size_t expected_value{};
-            ReadLineFromFileWithPixels(line, &expected_value, &input_values);
-            current_network_->LearnNetwork(input_values, expected_value);
-          }
-          line_index++;
-          if (line_index == coef) line_index = 0;
+          lines.push_back(line);
         }
       }
-      stream.clear();
-      stream.seekg(0, std::ios_base::beg);
-      line_index = 0;
-      while (!stream.eof()) {
-        std::getline(stream, line);
-        if (!line.empty()) {
-          if (line_index == i) {
-            std::vector<unsigned> input_values{};
-            size_t expected_value{};
-            ReadLineFromFileWithPixels(line, &expected_value, &input_values);
-            if (current_network_->Prediction(input_values) == expected_value) {
-              ++correct_pr;
-            }
-            ++all_pr;
-          }
-          line_index++;
-          if (line_index == coef) line_index = 0;
-        }
+      if (lines.empty()) {
+        break;
       }
-      stream.close();
+
+      /*---кусок потока - подряд идущие строки порции---*/
+      size_t chunk = (lines.size() + threads - 1) / threads;
+      pool_->ParallelFor(0, lines.size(), chunk,
+                         [&](const size_t &first, const size_t &last) {
+        std::vector<unsigned> input_values{};
+        InferenceWorkspace *workspace = workspaces[first / chunk].get();
+        for (size_t i = first; i < last; ++i) {
+          size_t expected_value{};
+          input_values.clear();
+          ReadLineFromFileWithPixels(lines[i], &expected_value,
+                                     &input_values);
+          current_network_->LearnNetwork(input_values, expected_value,
+                                         workspace);
+        }
+      });
+      samples += lines.size();
     }
-    res.push_back((double)correct_pr / (double)all_pr);
+    stream.close();
   }
-  return res;
+  return samples;
 }
 
-std::pair<size_t, size_t> Network::StartTestNetwork(
-    const std::string &test_file_name) {
-  size_t all_prediction = 0;
-  size_t correct_prediction = 0;
+void Network::ParseLines(const std::vector<std::string> &lines,
+                         std::vector<std::vector<unsigned>> *samples,
+                         std::vector<size_t> *labels) {
+  samples->resize(lines.size());
+  labels->resize(lines.size());
+  size_t grain = (lines.size() + pool_->get_threads() - 1) /
+                 pool_->get_threads();
+  pool_->ParallelFor(0, lines.size(), grain,
+                     [&](const size_t &first, const size_t &last) {
+    for (size_t i = first; i < last; ++i) {
+      (*samples)[i].clear();
+      ReadLineFromFileWithPixels(lines[i], &(*labels)[i], &(*samples)[i]);
+    }
+  });
+}
 
-  std::ifstream stream(test_file_name);
+void Network::LearnBatchParallel(
+    const std::vector<std::vector<unsigned>> &samples,
+    const std::vector<size_t> &labels,
+    const std::vector<std::unique_ptr<InferenceWorkspace>> &workspaces) {
+  size_t count = samples.size();
+  size_t part = (count + workspaces.size() - 1) / workspaces.size();
+  size_t parts = (count + part - 1) / part;
+  pool_->ParallelFor(parts, [&](const size_t &t) {
+    current_matrix_network_->AccumulateGradient(
+        samples, labels, t * part, std::min(part, count - t * part),
+        workspaces[t].get());
+  });
+
+  /*---на шаге stride часть t прибавляет к себе сумму части t + stride, пары
+   * шага складываются одновременно; за log2(parts) шагов вся сумма
+   * собирается в части 0---*/
+  for (size_t stride = 1; stride < parts; stride *= 2) {
+    size_t pairs = (parts - stride - 1) / (2 * stride) + 1;
+    pool_->ParallelFor(pairs, [&](const size_t &p) {
+      size_t t = p * 2 * stride;
+      current_matrix_network_->AddGradient(workspaces[t + stride].get(),
+                                           workspaces[t].get());
+    });
+  }
+  current_matrix_network_->ApplyGradient(workspaces.front().get(), count);
+}
+
+void Network::CheckSchedule(const LearningSchedule &schedule,
+                            const std::string &test_file) {
+  if (schedule.warmup_epochs < 0 || schedule.patience < 0) {
+    throw std::invalid_argument(
+        "Error in schedule, warmup and patience must be >= 0");
+  }
+  if (schedule.type == ScheduleType::kStep &&
+      (schedule.step_epochs < 1 || schedule.gamma <= 0)) {
+    throw std::invalid_argument(
+        "Error in schedule, step schedule needs stepEpochs >= 1, gamma > 0");
+  }
+  if (schedule.type == ScheduleType::kCosine && schedule.min_rate < 0) {
+    throw std::invalid_argument("Error in schedule, minRate < 0");
+  }
+  if (schedule.patience > 0 && test_file.empty()) {
+    throw std::invalid_argument(
+        "Error in schedule, early stopping needs a test file");
+  }
+}
+
+double Network::ScheduledLearningRate(const LearningSchedule &schedule,
+                                      const double &base_rate,
+                                      const int &epoch,
+                                      const int &sum_epoch) {
+  if (epoch < schedule.warmup_epochs) {
+    return base_rate * (epoch + 1) / (schedule.warmup_epochs + 1);
+  }
+  int t = epoch - schedule.warmup_epochs;
+  switch (schedule.type) {
+    case ScheduleType::kStep:
+      return base_rate * std::pow(schedule.gamma, t / schedule.step_epochs);
+    case ScheduleType::kCosine: {
+      int sum_t = sum_epoch - schedule.warmup_epochs;
+      const double kPi = std::acos(-1.0);
+      double cosine = (1 + std::cos(kPi * t / sum_t)) / 2;
+      return schedule.min_rate + (base_rate - schedule.min_rate) * cosine;
+    }
+    default:
+      return base_rate;
+  }
+}
+
+std::vector<double> Network::StartCVLearn(const std::string &train_file,
+                                          const unsigned coef,
+                                          const bool &continue_learn) {
+  if (continue_learn == false) InstallRandomWeights();
+
+  /*---файл читается и разбирается один раз, порциями, чтобы строки всего
+   * файла не лежали в памяти вместе с примерами---*/
+  std::vector<std::vector<unsigned>> samples{};
+  std::vector<size_t> labels{};
+  std::ifstream stream(train_file);
   if (stream.is_open()) {
     setlocale(LC_ALL, "en_US.UTF-8");
-    while (!stream.eof()) {
-      std::string line{};
-      std::getline(stream, line);
-      if (!line.empty()) {
-        std::vector<unsigned> input_values;
-        size_t expected_value{};
-        ReadLineFromFileWithPixels(line, &expected_value, &input_values);
-        /*---запускаем проход по сети и сравниваем с ожидаемым занчением---*/
-        if (current_network_->Prediction(input_values) == expected_value) {
-          ++correct_prediction;
+    size_t portion = pool_->get_threads() * kPredictBatchSize;
+    std::vector<std::string> lines{};
+    std::vector<std::vector<unsigned>> portion_samples{};
+    std::vector<size_t> portion_labels{};
+    std::string line{};
+    while (stream) {
+      lines.clear();
+      while (lines.size() < portion && std::getline(stream, line)) {
+        if (!line.empty()) {
+          lines.push_back(line);
         }
-        ++all_prediction;
+      }
+      ParseLines(lines, &portion_samples, &portion_labels);
+      for (size_t i = 0; i < lines.size(); ++i) {
+        samples.push_back(std::move(portion_samples[i]));
+        labels.push_back(portion_labels[i]);
       }
     }
     stream.close();
   }
-  return {all_prediction, correct_prediction};
+
+  /*---фолд i учится на строках, чей номер по модулю coef не равен i, и
+   * проверяется на строках, где равен. У каждого фолда своя копия сети,
+   * поэтому фолды считаются задачами пула одновременно, а сама сеть не
+   * меняется---*/
+  std::vector<double> res(coef);
+  pool_->ParallelFor(coef, [&](const size_t &i) {
+    std::unique_ptr<InterfaceNetwork> replica(current_network_->Clone());
+    for (size_t j = 0; j < samples.size(); ++j) {
+      if (j % coef != i) {
+        replica->LearnNetwork(samples[j], labels[j]);
+      }
+    }
+    size_t correct_pr{}, all_pr{};
+    for (size_t j = i; j < samples.size(); j += coef) {
+      if (replica->Prediction(samples[j]) == labels[j]) {
+        ++correct_pr;
+      }
+      ++all_pr;
+    }
+    res[i] = (double)correct_pr / (double)all_pr;
+  });
+  return res;
+}
+
+std::pair<size_t, size_t> Network::StartTestNetwork(
+    const std::string &test_file_name) {
+  return EvaluateFile(test_file_name, std::numeric_limits<size_t>::max(),
+                      nullptr);
 }
 
 std::pair<size_t, size_t> Network::StartTestNetwork(
@@ -170,78 +406,27 @@ std::pair<size_t, size_t> Network::StartTestNetwork(
   if (sample_percentage > 1.00 || sample_percentage <= 0.0) {
     throw std::invalid_argument("Error sample percentage");
   }
-
-  size_t all_prediction = 0;
-  size_t correct_prediction = 0;
-
-  std::ifstream stream(test_file_name);
-  if (stream.is_open()) {
-    int sum_test_in_file = 0;
-    std::string line{};
-    while (!stream.eof()) {
-      std::getline(stream, line);
-      if (!line.empty()) {
-        ++sum_test_in_file;
-      }
-    }
-    sum_test_in_file *= sample_percentage;
-    stream.clear();
-    stream.seekg(0, std::ios_base::beg);
-    for (int i = 0; i < sum_test_in_file; ++i) {
-      std::getline(stream, line);
-      if (!line.empty()) {
-        std::vector<unsigned> input_values;
-        size_t expected_value{};
-        ReadLineFromFileWithPixels(line, &expected_value, &input_values);
-        if (current_network_->Prediction(input_values) == expected_value) {
-          ++correct_prediction;
-        }
-        ++all_prediction;
-      }
-    }
-    stream.close();
-  }
-  return {all_prediction, correct_prediction};
+  size_t sum_test_in_file =
+      CountLinesInFile(test_file_name) * sample_percentage;
+  return EvaluateFile(test_file_name, sum_test_in_file, nullptr);
 }
 
-S21Matrix Network::StartConfusionTest(const std::string &test_file_name,
-                                      const double &sample_percentage) {
+S21Matrix<double> Network::StartConfusionTest(
+    const std::string &test_file_name, const double &sample_percentage) {
   if (sample_percentage > 1.00 || sample_percentage <= 0.0) {
     throw std::invalid_argument("Error sample percentage");
   }
 
-  S21Matrix res(kSumNeironsOutputLayer,
-                kSumNeironsOutputLayer);  // (expected / prediction)
+  S21Matrix<double> res(kSumNeironsOutputLayer,
+                        kSumNeironsOutputLayer);  // (expected / prediction)
 
-  std::ifstream stream(test_file_name);
-  if (stream.is_open()) {
-    int sum_test_in_file = 0;
-    std::string line{};
-    while (!stream.eof()) {
-      std::getline(stream, line);
-      if (!line.empty()) {
-        ++sum_test_in_file;
-      }
-    }
-    sum_test_in_file *= sample_percentage;
-    stream.clear();
-    stream.seekg(0, std::ios_base::beg);
-    for (int i = 0; i < sum_test_in_file; ++i) {
-      std::getline(stream, line);
-      if (!line.empty()) {
-        std::vector<unsigned> input_values;
-        size_t expected_value{};
-        ReadLineFromFileWithPixels(line, &expected_value, &input_values);
-        res(expected_value - 1,
-            current_network_->Prediction(input_values) - 1) += 1;
-      }
-    }
-    stream.close();
-  }
+  size_t sum_test_in_file =
+      CountLinesInFile(test_file_name) * sample_percentage;
+  EvaluateFile(test_file_name, sum_test_in_file, &res);
   return res;
 }
 
-double Network::CalcAccuracy(const S21Matrix &conf_mx) {
+double Network::CalcAccuracy(const S21Matrix<double> &conf_mx) {
   double correct{}, total{};
   for (unsigned i{}; i < kSumNeironsOutputLayer; i++) {
     for (unsigned j{}; j < kSumNeironsOutputLayer; j++) {
@@ -252,7 +437,7 @@ double Network::CalcAccuracy(const S21Matrix &conf_mx) {
   return correct / total;
 }
 
-double Network::CalcPrecision(const S21Matrix &conf_mx) {
+double Network::CalcPrecision(const S21Matrix<double> &conf_mx) {
   double correct[kSumNeironsOutputLayer]{}, positives[kSumNeironsOutputLayer]{};
   for (unsigned i{}; i < kSumNeironsOutputLayer; i++) {
     for (unsigned j{}; j < kSumNeironsOutputLayer; j++) {
@@ -271,7 +456,7 @@ double Network::CalcPrecision(const S21Matrix &conf_mx) {
   return res / existing_cases;
 }
 
-double Network::CalcRecall(const S21Matrix &conf_mx) {
+double Network::CalcRecall(const S21Matrix<double> &conf_mx) {
   double correct[kSumNeironsOutputLayer]{}, positives[kSumNeironsOutputLayer]{};
   for (unsigned i{}; i < kSumNeironsOutputLayer; i++) {
     for (unsigned j{}; j < kSumNeironsOutputLayer; j++) {
@@ -295,7 +480,7 @@ double Network::CalcFMeasure(const double prec, const double recall) {
 }
 
 void Network::ChangeCurrentNetwork(const int &index_network,
-                                   const bool &type_network) {
+                                   const int &type_network) {
   if (index_network < 0 || (size_t)index_network >= kSumNetworks) {
     throw std::invalid_argument(
         "Error in changeCurrentNetwork(), index Network out of range");
@@ -305,11 +490,19 @@ void Network::ChangeCurrentNetwork(const int &index_network,
       throw std::out_of_range("Index network out of range");
     }
     current_network_ = matrix_network_[index_network];
+    current_matrix_network_ = matrix_network_[index_network];
   } else if (type_network == typeNetwork::Graph) {
     if ((size_t)index_network >= graph_network_.size()) {
       throw std::out_of_range("Index network out of range");
     }
     current_network_ = graph_network_[index_network];
+    current_matrix_network_ = nullptr;
+  } else if (type_network == typeNetwork::Fixed) {
+    if ((size_t)index_network >= fixed_network_.size()) {
+      throw std::out_of_range("Index network out of range");
+    }
+    current_network_ = fixed_network_[index_network];
+    current_matrix_network_ = nullptr;
   }
 }
 
@@ -317,6 +510,192 @@ size_t Network::PredictionNetwork(const std::vector<unsigned> &input_layer) {
   return current_network_->Prediction(input_layer);
 }
 
+void Network::SetSigmoidMode(const s21_kernels::SigmoidMode &mode) {
+  current_network_->set_sigmoid_mode(mode);
+}
+
+void Network::SetOptimizer(const OptimizerConfig &config) {
+  current_network_->set_optimizer(config);
+}
+
+void Network::SetLearningRate(const double &learning_rate) {
+  current_network_->set_learning_rate(learning_rate);
+}
+
+void Network::SetOutputType(const OutputType &type) {
+  current_network_->set_output_type(type);
+}
+
+void Network::SetActivation(const size_t &layer,
+                            const s21_kernels::Activation &activation) {
+  current_network_->set_activation(layer, activation);
+}
+
+void Network::SetComputeBackend(const s21_kernels::BackendType &backend) {
+  for (auto network : matrix_network_) network->set_backend(backend);
+}
+
+void Network::SetPoolThreads(const unsigned &threads) {
+  ThreadPool *pool = new ThreadPool(threads);
+  for (auto network : matrix_network_) network->set_thread_pool(pool);
+  delete pool_;
+  pool_ = pool;
+}
+
+void Network::SetEvaluationThreads(const unsigned &threads) {
+  evaluation_threads_ = threads;
+}
+
+void Network::SetLearnThreads(const unsigned &threads) {
+  learn_threads_ = threads;
+}
+
+void Network::SetRandomSeed(const unsigned &seed) {
+  fixed_seed_ = true;
+  seed_ = seed;
+}
+
+void Network::InstallRandomWeights() {
+  if (fixed_seed_) {
+    current_network_->InstallRandomWeights(seed_);
+  } else {
+    current_network_->InstallRandomWeights();
+  }
+}
+
+LearnSpeed Network::get_learn_speed() const { return learn_speed_; }
+
+size_t Network::ThreadsOrPool(const unsigned &threads) const {
+  return threads == 0 ? pool_->get_threads() : threads;
+}
+
+size_t Network::CountLinesInFile(const std::string &filename) {
+  size_t sum_lines = 0;
+  std::ifstream stream(filename);
+  if (stream.is_open()) {
+    std::string line{};
+    while (std::getline(stream, line)) {
+      if (!line.empty()) {
+        ++sum_lines;
+      }
+    }
+    stream.close();
+  }
+  return sum_lines;
+}
+
+std::pair<size_t, size_t> Network::EvaluateFile(
+    const std::string &test_file_name, const size_t &max_lines,
+    S21Matrix<double> *confusion) {
+  size_t threads = ThreadsOrPool(evaluation_threads_);
+  std::vector<EvaluationCounts> counts(threads);
+  std::vector<std::unique_ptr<InferenceWorkspace>> workspaces{};
+  for (size_t t = 0; t < threads; ++t) {
+    if (confusion != nullptr) {
+      counts[t].confusion.assign(
+          kSumNeironsOutputLayer * kSumNeironsOutputLayer, 0);
+    }
+    workspaces.emplace_back(current_network_->CreateWorkspace());
+  }
+
+  std::ifstream stream(test_file_name);
+  if (stream.is_open()) {
+    setlocale(LC_ALL, "en_US.UTF-8");
+    /*---порция - по пакету на каждый поток---*/
+    size_t portion = threads * kPredictBatchSize;
+    std::vector<std::string> lines{};
+    std::string line{};
+    size_t read_lines = 0;
+    while (read_lines < max_lines) {
+      lines.clear();
+      while (lines.size() < portion && read_lines < max_lines &&
+             std::getline(stream, line)) {
+        ++read_lines;
+        if (!line.empty()) {
+          lines.push_back(line);
+        }
+      }
+      if (lines.empty()) {
+        break;
+      }
+
+      size_t batches = (lines.size() + kPredictBatchSize - 1) /
+                       kPredictBatchSize;
+      pool_->ParallelFor(batches, [&](const size_t &t) {
+        size_t first = t * kPredictBatchSize;
+        size_t count = std::min(kPredictBatchSize, lines.size() - first);
+        EvaluateBatch(lines, first, count, workspaces[t].get(), &counts[t]);
+      });
+    }
+    stream.close();
+  }
+
+  /*---счетчики целые, поэтому сумма не зависит от числа потоков---*/
+  std::pair<size_t, size_t> result{0, 0};
+  for (auto &partial : counts) {
+    result.first += partial.sum_tests;
+    result.second += partial.correct;
+    for (size_t i = 0; i < partial.confusion.size(); ++i) {
+      (*confusion)(i / kSumNeironsOutputLayer, i % kSumNeironsOutputLayer) +=
+          partial.confusion[i];
+    }
+  }
+  return result;
+}
+
+void Network::EvaluateBatch(const std::vector<std::string> &lines,
+                            const size_t &first, const size_t &count,
+                            InferenceWorkspace *workspace,
+                            EvaluationCounts *counts) {
+  std::vector<uint8_t> pixels{};
+  std::vector<size_t> expected(count);
+  std::vector<size_t> predictions(count);
+  std::vector<size_t> batched{};  // номера примеров, попавших в пакет
+  std::vector<unsigned> input_values{};
+  pixels.reserve(count * kInputLayer);
+  for (size_t i = 0; i < count; ++i) {
+    input_values.clear();
+    ReadLineFromFileWithPixels(lines[first + i], &expected[i], &input_values);
+    /*---пакет хранит пиксели байтами; пример другого размера или с
+     * яркостью больше 255 считается через Prediction, как при тесте в один
+     * поток, поэтому и ответ, и ошибка у него те же---*/
+    bool fits = input_values.size() == kInputLayer;
+    for (size_t j = 0; fits && j < input_values.size(); ++j) {
+      fits = input_values[j] <= 255;
+    }
+    if (!fits) {
+      predictions[i] = current_network_->Prediction(input_values, workspace);
+      continue;
+    }
+    batched.push_back(i);
+    pixels.insert(pixels.end(), input_values.begin(), input_values.end());
+  }
+
+  if (!batched.empty()) {
+    std::vector<size_t> batch_predictions(batched.size());
+    current_network_->PredictBatch(pixels.data(), batched.size(),
+                                   batch_predictions.data(), workspace);
+    for (size_t k = 0; k < batched.size(); ++k) {
+      predictions[batched[k]] = batch_predictions[k];
+    }
+  }
+  for (size_t i = 0; i < count; ++i) {
+    ++counts->sum_tests;
+    if (expected[i] == predictions[i]) {
+      ++counts->correct;
+    }
+    if (!counts->confusion.empty()) {
+      if (expected[i] < 1 || expected[i] > kSumNeironsOutputLayer) {
+        throw std::out_of_range("Error, answer " +
+                                std::to_string(expected[i]) +
+                                " of test file is out of range");
+      }
+      counts->confusion[(expected[i] - 1) * kSumNeironsOutputLayer +
+                        predictions[i] - 1] += 1;
+    }
+  }
+}
+
 void Network::ReadLineFromFileWithPixels(const std::string &line,
                                          size_t *expected_value,
                                          std::vector<unsigned> *input_values) {
@@ -1,25 +1,83 @@
 #pragma once
 
+#include <memory>
+
+#include "fixedNetwork.hpp"
 #include "matrixNetwork.hpp"
 #include "graphNetwork.hpp"
+#include "threadPool.hpp"
 
 namespace s21_network {
 
 enum SumHiddenLayers { TwoHids = 2, ThreeHids, FourHids, FiveHids, N };
-enum typeNetwork { Matrix, Graph };
+/*---Fixed - FixedNetwork, те же матричные вычисления с размерами слоев,
+ * заданными при компиляции---*/
+enum typeNetwork { Matrix, Graph, Fixed };
 constexpr double kLearningRate = 0.12;
 constexpr size_t kSumNetworks = 4;
+/*---сколько изображений тестового файла распознается за один вызов
+ * PredictBatch---*/
+constexpr size_t kPredictBatchSize = 256;
+/*---сколько строк файла обучения достается одной части Hogwild за
+ * порцию---*/
+constexpr size_t kHogwildPortionSize = 512;
+
+/*---шаг обучения по эпохам, base - шаг сети на начало обучения:
+ *   kConstant - base
+ *   kStep     - base * gamma^(t / step_epochs)
+ *   kCosine   - от base до min_rate по полуволне косинуса за эпохи после
+ *               разгона
+ * t - номер эпохи после разгона; в первые warmup_epochs эпох шаг растет
+ * линейно, base * (epoch + 1) / (warmup_epochs + 1)---*/
+enum class ScheduleType { kConstant, kStep, kCosine };
+
+struct LearningSchedule {
+  ScheduleType type = ScheduleType::kConstant;
+  int warmup_epochs = 0;
+  int step_epochs = 10;  // для kStep
+  double gamma = 0.5;    // для kStep
+  double min_rate = 0;   // для kCosine
+  /*---ранняя остановка по точности на тестовом файле: если она patience
+   * эпох подряд не выросла больше чем на min_delta, обучение прекращается.
+   * Если последняя пройденная эпоха хуже лучшей, после обучения сеть
+   * получает веса лучшей эпохи; 0 - без остановки---*/
+  int patience = 0;
+  double min_delta = 0;
+};
+
+/*---скорость последнего StartLearnNetwork: примеры всех эпох за время
+ * самого обучения, без проверок на тестовом файле---*/
+struct LearnSpeed {
+  unsigned threads = 1;
+  size_t samples = 0;
+  double seconds = 0;
+  double samples_per_second = 0;
+};
 
 class Network {
  public:
-  explicit Network(const double &learning_rate);
+  /*---матричные и фиксированные сети считают в типе scalar_type---*/
+  explicit Network(const double &learning_rate,
+                   const ScalarType &scalar_type = kDouble);
   ~Network();
 
   void LoadWeightsFromFile(const std::string &filename, const int &index_network);
   void SaveWeightsToFile(const std::string &filename);
 
+  /*---batch_size > 1 обучает матричную сеть пакетами (LearnBatch), графовая
+   * и фиксированная сети всегда учатся по одному примеру. schedule меняет
+   * шаг по эпохам, после обучения у сети снова прежний шаг---*/
   std::vector<double> StartLearnNetwork(const std::string &train_file, const int &sum_epoch,
-                         const bool &continue_learn, const std::string &test_file);
+                         const bool &continue_learn,
+                         const std::string &test_file,
+                         const size_t &batch_size = 1,
+                         const LearningSchedule &schedule = LearningSchedule());
+  /*---перекрестная проверка на coef фолдов: строки файла по кругу
+   * относятся к фолдам 0..coef-1, каждый фолд учит свою копию текущей
+   * сети на чужих строках и возвращает ее точность на своих, по порядку
+   * фолдов. Копии начинают с одних весов (случайных, если не
+   * continue_learn) и считаются в общем пуле одновременно, сама текущая
+   * сеть не обучается---*/
   std::vector<double> StartCVLearn(const std::string &train_file, const unsigned coef,
                                    const bool &continue_learn);
 
@@ -27,24 +85,112 @@ class Network {
   std::pair<size_t, size_t> StartTestNetwork(const std::string &test_file_name);
   std::pair<size_t, size_t> StartTestNetwork(const std::string &test_file_name,
                                              const double &sample_percentage);
-  S21Matrix StartConfusionTest(const std::string &test_file_name,
+  S21Matrix<double> StartConfusionTest(const std::string &test_file_name,
                                                const double &sample_percentage);
   // calculation of stats
-  double CalcAccuracy(const S21Matrix& conf_mx);
-  double CalcPrecision(const S21Matrix& conf_mx);
-  double CalcRecall(const S21Matrix& conf_mx);
+  double CalcAccuracy(const S21Matrix<double>& conf_mx);
+  double CalcPrecision(const S21Matrix<double>& conf_mx);
+  double CalcRecall(const S21Matrix<double>& conf_mx);
   double CalcFMeasure(double prec, double recall);
 
-  void ChangeCurrentNetwork(const int &index_network, const bool &type_network);
+  void ChangeCurrentNetwork(const int &index_network, const int &type_network);
   size_t PredictionNetwork(const std::vector<unsigned> &input_layer);
+  /*---режим сигмоиды меняется только у текущей сети---*/
+  void SetSigmoidMode(const s21_kernels::SigmoidMode &mode);
+  /*---оптимизатор, шаг обучения, тип выхода и функции активации слоев
+   * тоже меняются только у текущей сети---*/
+  void SetOptimizer(const OptimizerConfig &config);
+  void SetLearningRate(const double &learning_rate);
+  void SetOutputType(const OutputType &type);
+  void SetActivation(const size_t &layer,
+                     const s21_kernels::Activation &activation);
+  /*---бэкенд меняется у всех матричных сетей---*/
+  void SetComputeBackend(const s21_kernels::BackendType &backend);
+  /*---все параллельные части обучения, проверки и разбора строк отдают
+   * задачи одному пулу сети из threads потоков, 0 - по числу ядер (так по
+   * умолчанию). Настройки ниже задают, на сколько частей делится работа,
+   * 0 - по числу потоков пула---*/
+  void SetPoolThreads(const unsigned &threads);
+  /*---тестовые файлы StartTestNetwork и StartConfusionTest распознаются в
+   * threads частях; результат от их числа не зависит---*/
+  void SetEvaluationThreads(const unsigned &threads);
+  /*---StartLearnNetwork учит текущую сеть в threads частях, 1 - обычное
+   * обучение в одном потоке. При batch_size 1 это Hogwild: у каждой части
+   * свои строки файла и своя рабочая память, общие веса меняются без
+   * блокировок, порядок шагов от запуска к запуску разный; нужен простой
+   * шаг kSgd. При batch_size > 1 это синхронное обучение матричной сети:
+   * пакет делится на части, суммы их градиентов складываются деревом, на
+   * пакет один шаг. Части и порядок сложений зависят только от числа
+   * частей, поэтому при тех же весах и том же их числе обучение
+   * повторяется бит в бит. Иначе StartLearnNetwork бросает
+   * std::invalid_argument---*/
+  void SetLearnThreads(const unsigned &threads);
+  /*---обучение с нуля берет начальные веса из seed, а не из времени---*/
+  void SetRandomSeed(const unsigned &seed);
+  LearnSpeed get_learn_speed() const;
 
  protected:
   void ReadLineFromFileWithPixels(const std::string &line, size_t *expected_value,
                                   std::vector<unsigned> *input_values);
+  size_t CountLinesInFile(const std::string &filename);
+  /*---случайные веса текущей сети, из seed, если он задан---*/
+  void InstallRandomWeights();
+  static void CheckSchedule(const LearningSchedule &schedule,
+                            const std::string &test_file);
+  static double ScheduledLearningRate(const LearningSchedule &schedule,
+                                      const double &base_rate,
+                                      const int &epoch, const int &sum_epoch);
+  /*---счетчики ответов сети на тестовые изображения: всего, верных и,
+   * если нужна, матрица (ожидаемый, предсказанный ответ) по строкам---*/
+  struct EvaluationCounts {
+    size_t sum_tests = 0;
+    size_t correct = 0;
+    std::vector<size_t> confusion{};
+  };
+  /*---текущая сеть распознает первые max_lines строк файла пакетами по
+   * kPredictBatchSize. Строки читаются порциями, в порции у каждой части
+   * свои пакеты, своя рабочая память сети и свои счетчики, пакеты
+   * считаются задачами пула; после всех порций счетчики складываются.
+   * Пакеты те же, что при чтении в один поток, поэтому и итог тот же.
+   * confusion - матрица, к которой прибавляются ответы, или nullptr---*/
+  std::pair<size_t, size_t> EvaluateFile(const std::string &test_file_name,
+                                         const size_t &max_lines,
+                                         S21Matrix<double> *confusion);
+  void EvaluateBatch(const std::vector<std::string> &lines,
+                     const size_t &first, const size_t &count,
+                     InferenceWorkspace *workspace,
+                     EvaluationCounts *counts);
+  /*---эпоха Hogwild: строки файла читаются порциями по
+   * kHogwildPortionSize на часть, каждая часть учит сеть на своем куске
+   * порции через свою рабочую память. Возвращает число примеров---*/
+  size_t LearnEpochHogwild(const std::string &train_file,
+                           const size_t &threads);
+  /*---строки файла в примеры и ответы, строки делятся между потоками
+   * пула---*/
+  void ParseLines(const std::vector<std::string> &lines,
+                  std::vector<std::vector<unsigned>> *samples,
+                  std::vector<size_t> *labels);
+  /*---один синхронный шаг текущей матричной сети по пакету: части пакета
+   * по числу workspaces считаются задачами пула, их суммы градиентов
+   * складываются попарно деревом в первую workspace---*/
+  void LearnBatchParallel(
+      const std::vector<std::vector<unsigned>> &samples,
+      const std::vector<size_t> &labels,
+      const std::vector<std::unique_ptr<InferenceWorkspace>> &workspaces);
 
  private:
   std::vector<MatrixNetwork *> matrix_network_;  // вектор матрирчных сетей
   std::vector<GraphNetwork *> graph_network_;  // вектор графовых сетей
+  std::vector<InterfaceNetwork *> fixed_network_;  // вектор FixedNetwork
   InterfaceNetwork *current_network_;  // указатель на интерфес сети
+  MatrixNetwork *current_matrix_network_;  // она же, если сеть матричная
+  ThreadPool *pool_;                 // общий пул задач сети
+  unsigned evaluation_threads_ = 0;  // 0 - по числу потоков пула
+  unsigned learn_threads_ = 1;       // 1 - в одном потоке
+  bool fixed_seed_ = false;
+  unsigned seed_ = 0;
+  LearnSpeed learn_speed_{};
+
+  size_t ThreadsOrPool(const unsigned &threads) const;
 };
 }  // namespace s21_network
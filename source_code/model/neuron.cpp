@@ -1,10 +1,43 @@
 #include "neuron.h"
 
-#include <cmath>
+#include <cstddef>
+
+#include "matrixKernels.hpp"
 
 namespace s21_network {
 
-float SigmaFunction(float x) { return 1.0 / (1.0 + pow(M_E, -x)); }
+int ActMode(const s21_kernels::Activation& activation) {
+  switch (activation) {
+    case s21_kernels::Activation::kRelu:
+      return ActFunction::kRelu;
+    case s21_kernels::Activation::kLeakyRelu:
+      return ActFunction::kLeakyRelu;
+    case s21_kernels::Activation::kTanh:
+      return ActFunction::kTanh;
+    default:
+      return ActFunction::kSigmoid;
+  }
+}
+
+s21_kernels::Activation KernelActivation(int mode) {
+  switch (mode) {
+    case ActFunction::kRelu:
+      return s21_kernels::Activation::kRelu;
+    case ActFunction::kLeakyRelu:
+      return s21_kernels::Activation::kLeakyRelu;
+    case ActFunction::kTanh:
+      return s21_kernels::Activation::kTanh;
+    default:
+      return s21_kernels::Activation::kSigmoid;
+  }
+}
+
+Neuron::~Neuron() { delete optimizer_; }
+
+void Neuron::set_optimizer(Optimizer<float>* optimizer) {
+  delete optimizer_;
+  optimizer_ = optimizer;
+}
 
 void Neuron::AddInput(Neuron* inp, float wgt) {
   input_.push_back(inp);
@@ -14,16 +47,14 @@ void Neuron::AddInput(Neuron* inp, float wgt) {
 void Neuron::ClearInput() { input_.clear(); }
 
 void Neuron::set_mode(int src) {
-  if (src == ActFunction::kLinear || src == ActFunction::kSigmoid)
+  if (src >= ActFunction::kLinear && src <= ActFunction::kTanh)
     act_mode_ = src;
 }
 
 void Neuron::Activate() {
-  if (act_mode_ == ActFunction::kLinear) {
-    value_ = SumInput();
-  } else {
-    value_ = SigmaFunction(SumInput());
-  }
+  value_ = SumInput();
+  if (act_mode_ != ActFunction::kLinear)
+    s21_kernels::Activate(&value_, 1, KernelActivation(act_mode_));
 }
 
 void Neuron::set_deriv(const float& val) {
@@ -41,12 +72,33 @@ float Neuron::SumInput() {
   return res;
 }
 
+float Neuron::SumInput(const std::vector<float>& input_values) const {
+  float res{};
+  for (size_t i{}; i < input_.size(); i++)
+    res += weight_[i] * input_values[i];
+  return res;
+}
+
 void Neuron::CorrectWeights(float learning_rate) {
+  if (optimizer_) {
+    direction_.resize(weight_.size());
+    for (size_t i{}; i < weight_.size(); i++)
+      direction_[i] = -input_[i]->get_value() * deriv_;
+    optimizer_->Step(weight_.data(), direction_.data(), weight_.size(),
+                     learning_rate);
+    return;
+  }
   for (size_t i{}; i < weight_.size(); i++) {
     CorrectWeidht(i, learning_rate);
   }
 }
 
+void Neuron::CorrectWeights(const std::vector<float>& input_values,
+                            float deriv, float learning_rate) {
+  for (size_t i{}; i < weight_.size(); i++)
+    weight_[i] -= learning_rate * input_values[i] * deriv;
+}
+
 void Neuron::CorrectWeidht(int inp_index, float learning_rate) {
   weight_[inp_index] -= learning_rate * input_[inp_index]->get_value() * deriv_;
 }
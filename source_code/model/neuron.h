@@ -2,9 +2,17 @@
 
 #include <vector>
 
+#include "matrixKernels.hpp"
+#include "optimizer.hpp"
+
 namespace s21_network {
 
-enum ActFunction { kLinear, kSigmoid };
+enum ActFunction { kLinear, kSigmoid, kRelu, kLeakyRelu, kTanh };
+
+/*---режим нейрона по функции активации ядер и обратно, у kLinear своей
+ * функции в ядрах нет---*/
+int ActMode(const s21_kernels::Activation& activation);
+s21_kernels::Activation KernelActivation(int mode);
 
 class Neuron {
   std::vector<Neuron*> input_{};
@@ -12,9 +20,14 @@ class Neuron {
   float value_{};
   int act_mode_{};
   float deriv_{};
+  Optimizer<float>* optimizer_{};  // nullptr - простой шаг
+  std::vector<float> direction_{};  // направление шага для оптимизатора
 
  public:
   Neuron() {}
+  ~Neuron();
+  Neuron(const Neuron&) = delete;
+  Neuron& operator=(const Neuron&) = delete;
 
   float get_value() { return value_; }
   float& weight(int index) { return weight_[index]; }
@@ -24,16 +37,26 @@ class Neuron {
   void AddInput(Neuron* inp) { AddInput(inp, 1); }
   void ClearInput();
   void set_mode(int src);
+  int get_mode() const { return act_mode_; }
 
   void Activate();
 
   void set_deriv(const float& val);
   float get_deriv();
   void CorrectWeights(float learning_rate);
+  /*---простой шаг по сигналам входных нейронов input_values и чужой
+   * производной deriv, оптимизатор нейрона не участвует---*/
+  void CorrectWeights(const std::vector<float>& input_values, float deriv,
+                      float learning_rate);
+  /*---нейрон забирает оптимизатор себе, nullptr - простой шаг---*/
+  void set_optimizer(Optimizer<float>* optimizer);
+  float SumInput();
+  /*---сумма входов по сигналам входных нейронов, переданным в том же
+   * порядке, сам нейрон не меняется---*/
+  float SumInput(const std::vector<float>& input_values) const;
 
  private:
   void CorrectWeidht(int inp_index, float learning_rate);
-  float SumInput();
 };
 
 }  // namespace s21_network
@@ -0,0 +1,103 @@
+#include "optimizer.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "matrixKernels.hpp"
+
+namespace s21_network {
+
+namespace {
+
+/*––––––––––– momentum and Nesterov –––––––––––––––––*/
+
+template <typename T>
+class MomentumOptimizer : public Optimizer<T> {
+ public:
+  MomentumOptimizer(const T &momentum, const bool &nesterov)
+      : momentum_(momentum), nesterov_(nesterov) {}
+
+  void Step(T *weights, const T *direction, const size_t &n,
+            const T &learning_rate) override {
+    if (velocity_.size() != n) velocity_.assign(n, 0);
+    /*---у Нестерова шаг делается из точки, куда веса унесет инерция---*/
+    s21_kernels::MomentumStep(weights, direction, velocity_.data(), (int)n,
+                              learning_rate, momentum_, nesterov_);
+  }
+
+  OptimizerType get_type() const override {
+    return nesterov_ ? OptimizerType::kNesterov : OptimizerType::kMomentum;
+  }
+
+ private:
+  T momentum_;
+  bool nesterov_;
+  std::vector<T> velocity_;  // накопленное направление каждого веса
+};
+
+/*––––––––––– Adam ––––––––––––––––––––––––––––––––––*/
+
+template <typename T>
+class AdamOptimizer : public Optimizer<T> {
+ public:
+  explicit AdamOptimizer(const OptimizerConfig &config)
+      : beta1_(config.beta1),
+        beta2_(config.beta2),
+        epsilon_(config.epsilon),
+        beta1_power_(1),
+        beta2_power_(1) {}
+
+  void Step(T *weights, const T *direction, const size_t &n,
+            const T &learning_rate) override {
+    if (mean_.size() != n) {
+      mean_.assign(n, 0);
+      square_.assign(n, 0);
+      beta1_power_ = 1;
+      beta2_power_ = 1;
+    }
+    /*---средние стартуют с нуля, поправка на это входит в общий шаг---*/
+    beta1_power_ *= beta1_;
+    beta2_power_ *= beta2_;
+    T step = learning_rate * std::sqrt(1 - beta2_power_) / (1 - beta1_power_);
+    s21_kernels::AdamStep(weights, direction, mean_.data(), square_.data(),
+                          (int)n, step, beta1_, beta2_, epsilon_);
+  }
+
+  OptimizerType get_type() const override { return OptimizerType::kAdam; }
+
+ private:
+  T beta1_, beta2_, epsilon_;
+  double beta1_power_, beta2_power_;  // beta1^t и beta2^t после t шагов
+  std::vector<T> mean_;    // скользящее среднее направления
+  std::vector<T> square_;  // и его квадрата
+};
+
+}  // namespace
+
+template <typename T>
+Optimizer<T> *Optimizer<T>::Create(const OptimizerConfig &config) {
+  switch (config.type) {
+    case OptimizerType::kSgd:
+      return nullptr;
+    case OptimizerType::kMomentum:
+    case OptimizerType::kNesterov:
+      if (config.momentum < 0 || config.momentum >= 1) {
+        throw std::invalid_argument("Error, momentum must be in [0, 1)");
+      }
+      return new MomentumOptimizer<T>(
+          config.momentum, config.type == OptimizerType::kNesterov);
+    case OptimizerType::kAdam:
+      if (config.beta1 < 0 || config.beta1 >= 1 || config.beta2 < 0 ||
+          config.beta2 >= 1 || config.epsilon <= 0) {
+        throw std::invalid_argument(
+            "Error, Adam needs beta1 and beta2 in [0, 1) and epsilon > 0");
+      }
+      return new AdamOptimizer<T>(config);
+  }
+  throw std::invalid_argument("Error, unknown optimizer");
+}
+
+template class Optimizer<float>;
+template class Optimizer<double>;
+
+}  // namespace s21_network
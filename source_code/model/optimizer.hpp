@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace s21_network {
+
+/*---как направление коррекции d (минус градиент ошибки) превращается в
+ * шаг весов:
+ *   kSgd      - w += lr * d, без состояния
+ *   kMomentum - v = mu * v + d, w += lr * v
+ *   kNesterov - v = mu * v + d, w += lr * (d + mu * v)
+ *   kAdam     - свой шаг у каждого веса по скользящим средним d и d^2,
+ *               w += lr * m / (sqrt(v) + eps) с поправкой на старт;
+ *               шаг не зависит от масштаба d, lr нужен порядка 0.001---*/
+enum class OptimizerType { kSgd, kMomentum, kNesterov, kAdam };
+
+struct OptimizerConfig {
+  OptimizerType type = OptimizerType::kSgd;
+  double momentum = 0.9;  // mu для kMomentum и kNesterov
+  double beta1 = 0.9;     // затухание среднего d для kAdam
+  double beta2 = 0.999;   // затухание среднего d^2 для kAdam
+  double epsilon = 1e-8;
+};
+
+/*---оптимизатор одного блока весов (матрицы слоя или входов нейрона),
+ * хранит состояние на каждый вес блока---*/
+template <typename T>
+class Optimizer {
+ public:
+  /*---nullptr для kSgd: простой шаг сети делают сами, без лишнего прохода
+   * по весам; удаляет оптимизатор вызывающий---*/
+  static Optimizer *Create(const OptimizerConfig &config);
+  virtual ~Optimizer() {}
+
+  /*---weights[0..n) += шаг по direction[0..n); состояние обнуляется,
+   * если n отличается от прошлого вызова---*/
+  virtual void Step(T *weights, const T *direction, const size_t &n,
+                    const T &learning_rate) = 0;
+  virtual OptimizerType get_type() const = 0;
+};
+
+}  // namespace s21_network
@@ -0,0 +1,450 @@
+#pragma once
+
+#include <stdexcept>
+#include <type_traits>
+
+#include "matrixKernels.hpp"
+
+/* Lazy expressions over S21Matrix. Operators and functions below only
+ * describe a computation; it runs when the expression is assigned to a
+ * matrix (=, += or -=), row after row straight into the destination, so a
+ * chain like `w += lr * outer(x, delta)` or `sigmoid(x * w)` is a single
+ * loop without intermediate matrices.
+ *
+ * Every node provides get_rows(), get_columns(), EvalRow(row, dst) and
+ * Reads(data). Elementwise nodes (kElementwise) also provide at(row, col);
+ * a product or a sigmoid is evaluated a whole row at a time by a vector
+ * kernel, such a node may appear on one side of an elementwise operation
+ * only. kInPlaceSafe marks expressions that read the destination matrix
+ * only at the position being written, otherwise an expression reading the
+ * destination is evaluated into a temporary first. */
+
+template <typename T>
+class S21Matrix;
+
+template <class E>
+class S21MatrixExpr {
+ public:
+  const E& self() const { return static_cast<const E&>(*this); }
+};
+
+/*––––––––––– operands –––––––––––––––––––––––––––––––––––––––––––––––––––––*/
+
+template <typename T>
+class S21ExprLeaf : public S21MatrixExpr<S21ExprLeaf<T>> {
+ public:
+  using value_type = T;
+  static constexpr bool kElementwise = true;
+  static constexpr bool kInPlaceSafe = true;
+
+  explicit S21ExprLeaf(const S21Matrix<T>& matrix) : matrix_(matrix) {}
+
+  int get_rows() const { return matrix_.get_rows(); }
+  int get_columns() const { return matrix_.get_columns(); }
+  T at(const int& row, const int& column) const {
+    return matrix_.row(row)[column];
+  }
+  void EvalRow(const int& row, T* dst) const {
+    const T* line = matrix_.row(row);
+    for (int j = 0; j < get_columns(); ++j) dst[j] = line[j];
+  }
+  bool Reads(const void* data) const { return matrix_.data() == data; }
+
+ private:
+  const S21Matrix<T>& matrix_;
+};
+
+/* a matrix enters an expression by reference, a subexpression as a copy
+ * of its node */
+template <class X>
+struct S21ExprOperand {
+  using type = X;
+};
+
+template <typename T>
+struct S21ExprOperand<S21Matrix<T>> {
+  using type = S21ExprLeaf<T>;
+};
+
+template <class X>
+using S21ExprOperandT = typename S21ExprOperand<X>::type;
+
+template <class X>
+struct S21IsExprArg : std::is_base_of<S21MatrixExpr<X>, X> {};
+
+template <typename T>
+struct S21IsExprArg<S21Matrix<T>> : std::true_type {};
+
+template <class X>
+using S21ExprValueT = typename S21ExprOperandT<X>::value_type;
+
+template <class X, class R>
+using S21EnableIfExpr =
+    typename std::enable_if<S21IsExprArg<X>::value, R>::type;
+
+template <class L, class R, class Result>
+using S21EnableIfExprs = typename std::enable_if<
+    S21IsExprArg<L>::value && S21IsExprArg<R>::value, Result>::type;
+
+/*––––––––––– elementwise nodes ––––––––––––––––––––––––––––––––––––––––––––*/
+
+struct S21ExprAdd {
+  template <typename T>
+  static T Apply(const T& a, const T& b) {
+    return a + b;
+  }
+};
+
+struct S21ExprSub {
+  template <typename T>
+  static T Apply(const T& a, const T& b) {
+    return a - b;
+  }
+};
+
+struct S21ExprHadamard {
+  template <typename T>
+  static T Apply(const T& a, const T& b) {
+    return a * b;
+  }
+};
+
+template <class L, class R, class Op>
+class S21ExprBinary : public S21MatrixExpr<S21ExprBinary<L, R, Op>> {
+  static_assert(L::kElementwise || R::kElementwise,
+                "only one side of an elementwise operation may be a "
+                "product or a sigmoid");
+
+ public:
+  using value_type = typename L::value_type;
+  static constexpr bool kElementwise = L::kElementwise && R::kElementwise;
+  static constexpr bool kInPlaceSafe =
+      kElementwise && L::kInPlaceSafe && R::kInPlaceSafe;
+
+  S21ExprBinary(const L& lhs, const R& rhs) : lhs_(lhs), rhs_(rhs) {
+    if (lhs_.get_rows() != rhs_.get_rows() ||
+        lhs_.get_columns() != rhs_.get_columns()) {
+      throw std::invalid_argument("ERROR, matrices of different sizes");
+    }
+  }
+
+  int get_rows() const { return lhs_.get_rows(); }
+  int get_columns() const { return lhs_.get_columns(); }
+  value_type at(const int& row, const int& column) const {
+    return Op::Apply(lhs_.at(row, column), rhs_.at(row, column));
+  }
+  void EvalRow(const int& row, value_type* dst) const {
+    int columns = get_columns();
+    if constexpr (!L::kElementwise) {
+      lhs_.EvalRow(row, dst);
+      for (int j = 0; j < columns; ++j) {
+        dst[j] = Op::Apply(dst[j], rhs_.at(row, j));
+      }
+    } else if constexpr (!R::kElementwise) {
+      rhs_.EvalRow(row, dst);
+      for (int j = 0; j < columns; ++j) {
+        dst[j] = Op::Apply(lhs_.at(row, j), dst[j]);
+      }
+    } else {
+      for (int j = 0; j < columns; ++j) dst[j] = at(row, j);
+    }
+  }
+  bool Reads(const void* data) const {
+    return lhs_.Reads(data) || rhs_.Reads(data);
+  }
+
+ private:
+  L lhs_;
+  R rhs_;
+};
+
+template <class E>
+class S21ExprScale : public S21MatrixExpr<S21ExprScale<E>> {
+ public:
+  using value_type = typename E::value_type;
+  static constexpr bool kElementwise = E::kElementwise;
+  static constexpr bool kInPlaceSafe = E::kInPlaceSafe;
+
+  S21ExprScale(const value_type& scale, const E& expr)
+      : scale_(scale), expr_(expr) {}
+
+  int get_rows() const { return expr_.get_rows(); }
+  int get_columns() const { return expr_.get_columns(); }
+  const value_type& get_scale() const { return scale_; }
+  const E& get_expr() const { return expr_; }
+  value_type at(const int& row, const int& column) const {
+    return scale_ * expr_.at(row, column);
+  }
+  void EvalRow(const int& row, value_type* dst) const {
+    int columns = get_columns();
+    if constexpr (kElementwise) {
+      for (int j = 0; j < columns; ++j) dst[j] = at(row, j);
+    } else {
+      expr_.EvalRow(row, dst);
+      for (int j = 0; j < columns; ++j) dst[j] *= scale_;
+    }
+  }
+  bool Reads(const void* data) const { return expr_.Reads(data); }
+
+ private:
+  value_type scale_;
+  E expr_;
+};
+
+/* x^T * y for two rows x and y: element (i, j) is x[i] * y[j] */
+template <typename T>
+class S21ExprOuter : public S21MatrixExpr<S21ExprOuter<T>> {
+ public:
+  using value_type = T;
+  static constexpr bool kElementwise = true;
+  static constexpr bool kInPlaceSafe = false;
+
+  S21ExprOuter(const S21Matrix<T>& x, const S21Matrix<T>& y) : x_(x), y_(y) {
+    if (x_.get_rows() != 1 || y_.get_rows() != 1) {
+      throw std::invalid_argument("ERROR, outer product takes two rows");
+    }
+  }
+
+  int get_rows() const { return x_.get_columns(); }
+  int get_columns() const { return y_.get_columns(); }
+  const S21Matrix<T>& get_x() const { return x_; }
+  const S21Matrix<T>& get_y() const { return y_; }
+  T at(const int& row, const int& column) const {
+    return x_.row(0)[row] * y_.row(0)[column];
+  }
+  void EvalRow(const int& row, T* dst) const {
+    T scale = x_.row(0)[row];
+    const T* y = y_.row(0);
+    for (int j = 0; j < get_columns(); ++j) dst[j] = scale * y[j];
+  }
+  bool Reads(const void* data) const {
+    return x_.data() == data || y_.data() == data;
+  }
+
+ private:
+  const S21Matrix<T>& x_;
+  const S21Matrix<T>& y_;
+};
+
+/* s * (1 - s) for an expression s of sigmoid outputs, the derivative of the
+ * sigmoid expressed through its value */
+template <class E>
+class S21ExprSigmoidDerivative
+    : public S21MatrixExpr<S21ExprSigmoidDerivative<E>> {
+  static_assert(E::kElementwise,
+                "sigmoid_derivative takes an elementwise expression");
+
+ public:
+  using value_type = typename E::value_type;
+  static constexpr bool kElementwise = true;
+  static constexpr bool kInPlaceSafe = E::kInPlaceSafe;
+
+  explicit S21ExprSigmoidDerivative(const E& expr) : expr_(expr) {}
+
+  int get_rows() const { return expr_.get_rows(); }
+  int get_columns() const { return expr_.get_columns(); }
+  value_type at(const int& row, const int& column) const {
+    value_type sigmoid = expr_.at(row, column);
+    return sigmoid * (1 - sigmoid);
+  }
+  void EvalRow(const int& row, value_type* dst) const {
+    for (int j = 0; j < get_columns(); ++j) dst[j] = at(row, j);
+  }
+  bool Reads(const void* data) const { return expr_.Reads(data); }
+
+ private:
+  E expr_;
+};
+
+/*––––––––––– row nodes ––––––––––––––––––––––––––––––––––––––––––––––––––––*/
+
+template <class E>
+class S21ExprSigmoid : public S21MatrixExpr<S21ExprSigmoid<E>> {
+ public:
+  using value_type = typename E::value_type;
+  static constexpr bool kElementwise = false;
+  static constexpr bool kInPlaceSafe = E::kInPlaceSafe;
+
+  S21ExprSigmoid(const E& expr, const s21_kernels::SigmoidMode& mode)
+      : expr_(expr), mode_(mode) {}
+
+  int get_rows() const { return expr_.get_rows(); }
+  int get_columns() const { return expr_.get_columns(); }
+  void EvalRow(const int& row, value_type* dst) const {
+    expr_.EvalRow(row, dst);
+    s21_kernels::Sigmoid(dst, get_columns(), mode_);
+  }
+  bool Reads(const void* data) const { return expr_.Reads(data); }
+
+ private:
+  E expr_;
+  s21_kernels::SigmoidMode mode_;
+};
+
+/* any activation function of matrixKernels.hpp, a row at a time */
+template <class E>
+class S21ExprActivate : public S21MatrixExpr<S21ExprActivate<E>> {
+ public:
+  using value_type = typename E::value_type;
+  static constexpr bool kElementwise = false;
+  static constexpr bool kInPlaceSafe = E::kInPlaceSafe;
+
+  S21ExprActivate(const E& expr, const s21_kernels::Activation& activation,
+                  const s21_kernels::SigmoidMode& mode)
+      : expr_(expr), activation_(activation), mode_(mode) {}
+
+  int get_rows() const { return expr_.get_rows(); }
+  int get_columns() const { return expr_.get_columns(); }
+  void EvalRow(const int& row, value_type* dst) const {
+    expr_.EvalRow(row, dst);
+    s21_kernels::Activate(dst, get_columns(), activation_, mode_);
+  }
+  bool Reads(const void* data) const { return expr_.Reads(data); }
+
+ private:
+  E expr_;
+  s21_kernels::Activation activation_;
+  s21_kernels::SigmoidMode mode_;
+};
+
+/* marks the right operand of a product as transposed */
+template <typename T>
+struct S21ExprTransposed {
+  const S21Matrix<T>& matrix;
+};
+
+/* a * b or a * b^T, every row is one vector-times-matrix kernel; assigned
+ * on its own the product goes through the blocked S21Matrix::Gemm */
+template <typename T>
+class S21ExprProduct : public S21MatrixExpr<S21ExprProduct<T>> {
+ public:
+  using value_type = T;
+  static constexpr bool kElementwise = false;
+  static constexpr bool kInPlaceSafe = false;
+
+  S21ExprProduct(const S21Matrix<T>& a, const S21Matrix<T>& b,
+                 const bool& transpose_b)
+      : a_(a), b_(b), transpose_b_(transpose_b) {
+    if (a_.get_columns() !=
+        (transpose_b_ ? b_.get_columns() : b_.get_rows())) {
+      throw std::invalid_argument(
+          "ERROR in mult matrix columns unequal rows mult matrix");
+    }
+  }
+
+  int get_rows() const { return a_.get_rows(); }
+  int get_columns() const {
+    return transpose_b_ ? b_.get_rows() : b_.get_columns();
+  }
+  const S21Matrix<T>& get_a() const { return a_; }
+  const S21Matrix<T>& get_b() const { return b_; }
+  const bool& get_transpose_b() const { return transpose_b_; }
+
+  void EvalRow(const int& row, T* dst) const {
+    const T* x = a_.row(row);
+    int k = a_.get_columns();
+    if (!transpose_b_) {
+      s21_kernels::Gemv(x, b_.data(), k, b_.get_columns(), b_.get_stride(),
+                        dst);
+      return;
+    }
+    s21_kernels::GemvTransposed(x, b_.data(), k, b_.get_rows(),
+                                b_.get_stride(), dst);
+  }
+  bool Reads(const void* data) const {
+    return a_.data() == data || b_.data() == data;
+  }
+
+ private:
+  const S21Matrix<T>& a_;
+  const S21Matrix<T>& b_;
+  bool transpose_b_;
+};
+
+/*––––––––––– builders –––––––––––––––––––––––––––––––––––––––––––––––––––––*/
+
+template <class L, class R>
+using S21ExprAddT =
+    S21ExprBinary<S21ExprOperandT<L>, S21ExprOperandT<R>, S21ExprAdd>;
+
+template <class L, class R>
+S21EnableIfExprs<L, R, S21ExprAddT<L, R>> operator+(const L& lhs,
+                                                    const R& rhs) {
+  return {S21ExprOperandT<L>(lhs), S21ExprOperandT<R>(rhs)};
+}
+
+template <class L, class R>
+using S21ExprSubT =
+    S21ExprBinary<S21ExprOperandT<L>, S21ExprOperandT<R>, S21ExprSub>;
+
+template <class L, class R>
+S21EnableIfExprs<L, R, S21ExprSubT<L, R>> operator-(const L& lhs,
+                                                    const R& rhs) {
+  return {S21ExprOperandT<L>(lhs), S21ExprOperandT<R>(rhs)};
+}
+
+/* elementwise product */
+template <class L, class R>
+using S21ExprHadamardT =
+    S21ExprBinary<S21ExprOperandT<L>, S21ExprOperandT<R>, S21ExprHadamard>;
+
+template <class L, class R>
+S21EnableIfExprs<L, R, S21ExprHadamardT<L, R>> hadamard(const L& lhs,
+                                                        const R& rhs) {
+  return {S21ExprOperandT<L>(lhs), S21ExprOperandT<R>(rhs)};
+}
+
+template <class X>
+S21EnableIfExpr<X, S21ExprScale<S21ExprOperandT<X>>> operator*(
+    const S21ExprValueT<X>& scale, const X& expr) {
+  return {scale, S21ExprOperandT<X>(expr)};
+}
+
+template <class X>
+S21EnableIfExpr<X, S21ExprScale<S21ExprOperandT<X>>> operator*(
+    const X& expr, const S21ExprValueT<X>& scale) {
+  return {scale, S21ExprOperandT<X>(expr)};
+}
+
+template <typename T>
+S21ExprProduct<T> operator*(const S21Matrix<T>& a, const S21Matrix<T>& b) {
+  return {a, b, false};
+}
+
+template <typename T>
+S21ExprProduct<T> operator*(const S21Matrix<T>& a,
+                            const S21ExprTransposed<T>& b) {
+  return {a, b.matrix, true};
+}
+
+template <typename T>
+S21ExprTransposed<T> transpose(const S21Matrix<T>& matrix) {
+  return {matrix};
+}
+
+template <typename T>
+S21ExprOuter<T> outer(const S21Matrix<T>& x, const S21Matrix<T>& y) {
+  return {x, y};
+}
+
+template <class X>
+S21EnableIfExpr<X, S21ExprSigmoid<S21ExprOperandT<X>>> sigmoid(
+    const X& expr, const s21_kernels::SigmoidMode& mode =
+                       s21_kernels::SigmoidMode::kPrecise) {
+  return {S21ExprOperandT<X>(expr), mode};
+}
+
+template <class X>
+S21EnableIfExpr<X, S21ExprActivate<S21ExprOperandT<X>>> activate(
+    const X& expr, const s21_kernels::Activation& activation,
+    const s21_kernels::SigmoidMode& mode =
+        s21_kernels::SigmoidMode::kPrecise) {
+  return {S21ExprOperandT<X>(expr), activation, mode};
+}
+
+template <class X>
+S21EnableIfExpr<X, S21ExprSigmoidDerivative<S21ExprOperandT<X>>>
+sigmoid_derivative(const X& expr) {
+  return S21ExprSigmoidDerivative<S21ExprOperandT<X>>(
+      S21ExprOperandT<X>(expr));
+}
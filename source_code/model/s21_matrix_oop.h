@@ -1,61 +1,220 @@
 #pragma once
 
+#include <cassert>
 #include <cmath>
+#include <cstring>
 #include <iostream>
+#include <new>
+#include <type_traits>
+#include <vector>
 
+#include "matrixKernels.hpp"
+#include "s21_matrix_expr.h"
+
+/* Non-owning view of a row or a column of a matrix: `size` elements placed
+ * `step` elements apart. Access is unchecked so loops over a view can be
+ * vectorized, bounds are asserted in debug builds only. */
+template <typename T>
+class S21VectorView {
+ public:
+  S21VectorView(T* data, const int& size, const int& step = 1)
+      : data_(data), size_(size), step_(step) {}
+  /* a view of mutable elements converts to a read-only one */
+  template <typename U, typename = typename std::enable_if<
+                            std::is_same<const U, T>::value>::type>
+  S21VectorView(const S21VectorView<U>& other)
+      : data_(other.data()), size_(other.size()), step_(other.step()) {}
+
+  T& operator[](const int& index) const {
+    assert(index >= 0 && index < size_);
+    return data_[(size_t)index * step_];
+  }
+
+  T* data() const { return data_; }
+  int size() const { return size_; }
+  int step() const { return step_; }
+
+ private:
+  T* data_;
+  int size_;
+  int step_;
+};
+
+/* Non-owning view of a block of rows of a matrix, with the same unchecked
+ * access as S21VectorView. */
+template <typename T>
+class S21MatrixView {
+ public:
+  S21MatrixView(T* data, const int& rows, const int& columns,
+                const int& stride)
+      : data_(data), rows_(rows), columns_(columns), stride_(stride) {}
+  template <typename U, typename = typename std::enable_if<
+                            std::is_same<const U, T>::value>::type>
+  S21MatrixView(const S21MatrixView<U>& other)
+      : data_(other.data()),
+        rows_(other.get_rows()),
+        columns_(other.get_columns()),
+        stride_(other.get_stride()) {}
+
+  T& operator()(const int& row, const int& column) const {
+    assert(row >= 0 && row < rows_ && column >= 0 && column < columns_);
+    return data_[(size_t)row * stride_ + column];
+  }
+
+  S21VectorView<T> row(const int& index) const {
+    assert(index >= 0 && index < rows_);
+    return {data_ + (size_t)index * stride_, columns_};
+  }
+  S21VectorView<T> column(const int& index) const {
+    assert(index >= 0 && index < columns_);
+    return {data_ + index, rows_, stride_};
+  }
+
+  T* data() const { return data_; }
+  int get_rows() const { return rows_; }
+  int get_columns() const { return columns_; }
+  int get_stride() const { return stride_; }
+
+ private:
+  T* data_;
+  int rows_, columns_;
+  int stride_;
+};
+
+/* dense matrix of float or double elements */
+template <typename T = double>
 class S21Matrix {
+ public:
+  /* rows are aligned on a cache line, so they can be streamed with vector
+   * loads */
+  static constexpr int kAlignment = 64;
+
  private:
   int rows_, columns_;
-  double** matrix_;
+  int stride_;       // distance between two rows in elements (>= columns_)
+  T* matrix_;        // one row-major buffer of rows_ * stride_ elements
 
  private:
-  double SigmoidFunc(const double& value) { return (1 / (1 + exp(-value))); }
+  static int CalcStride(const int& columns) {
+    constexpr int kElementsInLine = kAlignment / sizeof(T);
+    return (columns + kElementsInLine - 1) / kElementsInLine * kElementsInLine;
+  }
 
   void DistributionMemory(const int& rows, const int& columns) {
     rows_ = rows;
     columns_ = columns;
-    matrix_ = new double*[rows_];
-    for (int i = 0; i < rows_; i++) {
-      matrix_[i] = new double[columns_]{};
+    stride_ = CalcStride(columns_);
+    size_t size = (size_t)rows_ * stride_;
+    matrix_ = static_cast<T*>(::operator new(
+        size * sizeof(T), std::align_val_t(kAlignment)));
+    /* zero the whole buffer, including the padding at the end of rows */
+    std::memset(matrix_, 0, size * sizeof(T));
+  }
+
+  s21_kernels::Operand<T> AsOperand(const bool& transpose) const {
+    if (transpose) {
+      return {matrix_, 1, stride_};
     }
+    return {matrix_, stride_, 1};
   }
 
-  void CheckDimensionMatrix(const S21Matrix& other) {
+  void CheckDimensionMatrix(const S21Matrix& other) const {
     if (columns_ != other.rows_) {
       throw std::invalid_argument(
           "ERROR in mult matrix columns unequal rows mult matrix");
     }
   }
 
+  /* this += sign * expr */
+  template <int kSign, class E>
+  void AccumulateExpr(const E& expr) {
+    if (expr.get_rows() != rows_ || expr.get_columns() != columns_) {
+      throw std::invalid_argument("ERROR, matrices of different sizes");
+    }
+    if (!E::kInPlaceSafe && expr.Reads(matrix_)) {
+      S21Matrix value(expr);
+      AccumulateExpr<kSign>(S21ExprLeaf<T>(value));
+      return;
+    }
+    if constexpr (E::kElementwise) {
+      for (int i = 0; i < rows_; ++i) {
+        T* dst = row(i);
+        for (int j = 0; j < columns_; ++j) dst[j] += kSign * expr.at(i, j);
+      }
+    } else {
+      /* a row node overwrites a whole row, so each row is evaluated into a
+       * per-thread scratch row that only grows, and then added */
+      static thread_local std::vector<T> line;
+      if (line.size() < (size_t)columns_) line.resize(columns_);
+      for (int i = 0; i < rows_; ++i) {
+        expr.EvalRow(i, line.data());
+        T* dst = row(i);
+        for (int j = 0; j < columns_; ++j) dst[j] += kSign * line[j];
+      }
+    }
+  }
+
+  /* this += sign * product: a single row goes through the row kernel, a
+   * product that reads this matrix through a temporary */
+  template <int kSign>
+  void AccumulateProduct(const S21ExprProduct<T>& product) {
+    const S21Matrix& a = product.get_a();
+    const S21Matrix& b = product.get_b();
+    if (product.get_rows() == 1 || this == &a || this == &b) {
+      AccumulateExpr<kSign>(product);
+      return;
+    }
+    if (product.get_rows() != rows_ || product.get_columns() != columns_) {
+      throw std::invalid_argument("ERROR, matrices of different sizes");
+    }
+    AddProduct(a, b, T(kSign), false, product.get_transpose_b());
+  }
+
+  void CheckOutputMatrix(const S21Matrix* result,
+                         const S21Matrix& other) const {
+    if (result == nullptr || result == this || result == &other) {
+      throw std::invalid_argument(
+          "ERROR, output matrix is nullptr or one of the operands");
+    }
+  }
+
  public:
   // constructors
-  S21Matrix(const int& rows, const int& columns) : matrix_(nullptr) {
+  S21Matrix(const int& rows, const int& columns)
+      : rows_(0), columns_(0), stride_(0), matrix_(nullptr) {
     if (rows < 1 || columns < 1) {
       throw std::invalid_argument("ERROR, invalid input");
     }
     DistributionMemory(rows, columns);
   }
 
-  S21Matrix(const S21Matrix& other) : matrix_(nullptr) { *this = other; }
+  S21Matrix(const S21Matrix& other)
+      : rows_(0), columns_(0), stride_(0), matrix_(nullptr) {
+    *this = other;
+  }
 
-  S21Matrix(S21Matrix&& other) : matrix_(nullptr) {
-    Clear();
+  S21Matrix(S21Matrix&& other)
+      : rows_(0), columns_(0), stride_(0), matrix_(nullptr) {
     Swap(other);
   }
+
+  /* evaluates a lazy expression from s21_matrix_expr.h */
+  template <class E>
+  S21Matrix(const S21MatrixExpr<E>& expr)
+      : rows_(0), columns_(0), stride_(0), matrix_(nullptr) {
+    *this = expr;
+  }
   // destructor
   ~S21Matrix() { Clear(); }
 
   /* Clear memory in matrix */
   void Clear() {
     if (matrix_ != nullptr) {
-      for (int i = 0; i < rows_; i++) {
-        delete[] matrix_[i];
-        matrix_[i] = nullptr;
-      }
-      delete[] matrix_;
+      ::operator delete(matrix_, std::align_val_t(kAlignment));
       matrix_ = nullptr;
       rows_ = 0;
       columns_ = 0;
+      stride_ = 0;
     }
   }
 
@@ -65,38 +224,221 @@ class S21Matrix {
     }
     std::swap(rows_, other.rows_);
     std::swap(columns_, other.columns_);
+    std::swap(stride_, other.stride_);
     std::swap(matrix_, other.matrix_);
   }
 
   /* accessors */
   int get_rows() const { return rows_; }
   int get_columns() const { return columns_; }
+  int get_stride() const { return stride_; }
+
+  /* raw access to the aligned buffer, row i starts at data() + i * stride */
+  T* data() { return matrix_; }
+  const T* data() const { return matrix_; }
+  T* row(const int& index) { return matrix_ + (size_t)index * stride_; }
+  const T* row(const int& index) const {
+    return matrix_ + (size_t)index * stride_;
+  }
+
+  /* unchecked element access for hot loops, bounds are asserted in debug
+   * builds only; operator() keeps the checks for callers at the API
+   * boundary */
+  T& element(const int& row, const int& column) {
+    assert(row >= 0 && row < rows_ && column >= 0 && column < columns_);
+    return matrix_[(size_t)row * stride_ + column];
+  }
+  T element(const int& row, const int& column) const {
+    assert(row >= 0 && row < rows_ && column >= 0 && column < columns_);
+    return matrix_[(size_t)row * stride_ + column];
+  }
+
+  /* views share the memory of the matrix and stay valid until it is
+   * reallocated */
+  S21MatrixView<T> view() { return {matrix_, rows_, columns_, stride_}; }
+  S21MatrixView<const T> view() const {
+    return {matrix_, rows_, columns_, stride_};
+  }
+  S21MatrixView<T> view(const int& first_row, const int& rows) {
+    assert(first_row >= 0 && rows >= 0 && first_row + rows <= rows_);
+    return {row(first_row), rows, columns_, stride_};
+  }
+  S21MatrixView<const T> view(const int& first_row, const int& rows) const {
+    assert(first_row >= 0 && rows >= 0 && first_row + rows <= rows_);
+    return {row(first_row), rows, columns_, stride_};
+  }
+  S21VectorView<T> row_view(const int& index) { return view().row(index); }
+  S21VectorView<const T> row_view(const int& index) const {
+    return view().row(index);
+  }
+  S21VectorView<T> column_view(const int& index) {
+    return view().column(index);
+  }
+  S21VectorView<const T> column_view(const int& index) const {
+    return view().column(index);
+  }
 
   void MulMatrix(const S21Matrix& other) {
-    CheckDimensionMatrix(other);
     S21Matrix result(rows_, other.columns_);
-    for (int i = 0; i < result.rows_; i++) {
-      for (int j = 0; j < result.columns_; j++) {
-        for (int k = 0; k < columns_; k++) {
-          result.matrix_[i][j] += matrix_[i][k] * other.matrix_[k][j];
-        }
-      }
-    }
+    MulInto(other, &result);
     Swap(result);
   }
 
   void MulMatrixWithSigmoid(const S21Matrix& other) {
-    CheckDimensionMatrix(other);
     S21Matrix result(rows_, other.columns_);
-    for (int i = 0; i < result.rows_; i++) {
-      for (int j = 0; j < result.columns_; j++) {
-        for (int k = 0; k < columns_; k++) {
-          result.matrix_[i][j] += matrix_[i][k] * other.matrix_[k][j];
-        }
-        result.matrix_[i][j] = SigmoidFunc(result.matrix_[i][j]);
+    MulWithSigmoidInto(other, &result);
+    Swap(result);
+  }
+
+  /* zeroes every element, the row padding included */
+  void SetZero() {
+    std::memset(matrix_, 0, (size_t)rows_ * stride_ * sizeof(T));
+  }
+
+  /* gives the matrix a new size, memory is reallocated only if the size
+   * actually changes, contents are unspecified afterwards */
+  void Resize(const int& rows, const int& columns) {
+    if (rows_ != rows || columns_ != columns) {
+      S21Matrix result(rows, columns);
+      Swap(result);
+    }
+  }
+
+  /* The *Into family writes into a caller-provided matrix and does not
+   * allocate once that matrix has the size of the result */
+
+  /* result = this * other */
+  void MulInto(const S21Matrix& other, S21Matrix* result) const {
+    CheckDimensionMatrix(other);
+    CheckOutputMatrix(result, other);
+    if (rows_ == 1) {
+      result->Resize(1, other.columns_);
+      s21_kernels::Gemv(matrix_, other.matrix_, columns_, other.columns_,
+                        other.stride_, result->matrix_);
+    } else {
+      result->Gemm(*this, other);
+    }
+  }
+
+  /* result = sigmoid(this * other), every row goes through a
+   * vector-times-matrix kernel picked for the host cpu, sigmoid is applied
+   * inside the kernel */
+  void MulWithSigmoidInto(const S21Matrix& other, S21Matrix* result,
+                          const s21_kernels::SigmoidMode& mode =
+                              s21_kernels::SigmoidMode::kPrecise) const {
+    CheckDimensionMatrix(other);
+    CheckOutputMatrix(result, other);
+    result->Resize(rows_, other.columns_);
+    for (int i = 0; i < rows_; i++) {
+      s21_kernels::GemvSigmoid(row(i), other.matrix_, columns_,
+                               other.columns_, other.stride_, result->row(i),
+                               nullptr, mode);
+    }
+  }
+
+  /* result = sigmoid(this * other + bias), bias is one row that is added to
+   * every row of the product before the activation */
+  void MulAddBiasWithSigmoidInto(const S21Matrix& other, const S21Matrix& bias,
+                                 S21Matrix* result,
+                                 const s21_kernels::SigmoidMode& mode =
+                                     s21_kernels::SigmoidMode::kPrecise) const {
+    CheckDimensionMatrix(other);
+    CheckOutputMatrix(result, other);
+    if (bias.rows_ != 1 || bias.columns_ != other.columns_ ||
+        result == &bias) {
+      throw std::invalid_argument("ERROR, bias isn't a row of the product");
+    }
+    result->Resize(rows_, other.columns_);
+    for (int i = 0; i < rows_; i++) {
+      s21_kernels::GemvSigmoid(row(i), other.matrix_, columns_,
+                               other.columns_, other.stride_, result->row(i),
+                               bias.matrix_, mode);
+    }
+  }
+
+  /* this += scale * x^T * y, x and y are rows of rows_ and columns_
+   * elements (rank-1 update of the matrix in place) */
+  void AddOuterProduct(const S21Matrix& x, const S21Matrix& y,
+                       const T& scale) {
+    if (x.rows_ != 1 || y.rows_ != 1 || x.columns_ != rows_ ||
+        y.columns_ != columns_) {
+      throw std::invalid_argument(
+          "ERROR in outer product, sizes of the rows don't match matrix");
+    }
+    s21_kernels::Ger(rows_, columns_, scale, x.matrix_, y.matrix_, matrix_,
+                     stride_);
+  }
+
+  /* this = op(a) * op(b), where op transposes the operand if its flag is
+   * set. The product is cache- and register-blocked, so it is the one to use
+   * for batches of samples. With a pool, panels of the result are computed
+   * by its threads (see s21_kernels::Gemm). The matrix is reallocated only
+   * if its size differs from the product */
+  void Gemm(const S21Matrix& a, const S21Matrix& b,
+            const bool& transpose_a = false, const bool& transpose_b = false,
+            s21_network::ThreadPool* pool = nullptr) {
+    int m = transpose_a ? a.columns_ : a.rows_;
+    int k = transpose_a ? a.rows_ : a.columns_;
+    int n = transpose_b ? b.rows_ : b.columns_;
+    if ((transpose_b ? b.columns_ : b.rows_) != k) {
+      throw std::invalid_argument(
+          "ERROR in gemm, inner dimensions of the operands are unequal");
+    }
+    if (this == &a || this == &b) {
+      S21Matrix result(m, n);
+      result.Gemm(a, b, transpose_a, transpose_b, pool);
+      Swap(result);
+      return;
+    }
+    Resize(m, n);
+    s21_kernels::Gemm(m, n, k, T(1), a.AsOperand(transpose_a),
+                      b.AsOperand(transpose_b), T(0), matrix_, stride_,
+                      pool);
+  }
+
+  /* this += scale * op(a) * op(b) on the same blocked gemm, the product is
+   * accumulated straight into the matrix, which must already have its
+   * size. For a^T * b this is the sum of the outer products of the rows of
+   * a and b, the batch form of AddOuterProduct; when most elements of a
+   * are zero (a batch of input pixels) the outer products are added one by
+   * one instead, the Ger kernel skips the zero elements. The gemm is split
+   * over the pool as in Gemm */
+  void AddProduct(const S21Matrix& a, const S21Matrix& b, const T& scale,
+                  const bool& transpose_a = false,
+                  const bool& transpose_b = false,
+                  s21_network::ThreadPool* pool = nullptr) {
+    int m = transpose_a ? a.columns_ : a.rows_;
+    int k = transpose_a ? a.rows_ : a.columns_;
+    int n = transpose_b ? b.rows_ : b.columns_;
+    if ((transpose_b ? b.columns_ : b.rows_) != k || m != rows_ ||
+        n != columns_) {
+      throw std::invalid_argument(
+          "ERROR in gemm, sizes of the operands don't match matrix");
+    }
+    if (this == &a || this == &b) {
+      throw std::invalid_argument(
+          "ERROR, output matrix is one of the operands");
+    }
+    if (transpose_a && !transpose_b && a.IsSparse()) {
+      for (int p = 0; p < k; ++p) {
+        s21_kernels::Ger(m, n, scale, a.row(p), b.row(p), matrix_, stride_);
       }
+      return;
     }
-    Swap(result);
+    s21_kernels::Gemm(m, n, k, scale, a.AsOperand(transpose_a),
+                      b.AsOperand(transpose_b), T(1), matrix_, stride_,
+                      pool);
+  }
+
+  /* true if less than 40% of the elements are nonzero, below that skipping
+   * zeros beats the blocked gemm */
+  bool IsSparse() const {
+    size_t nonzero = 0;
+    for (int i = 0; i < rows_; ++i) {
+      const T* line = row(i);
+      for (int j = 0; j < columns_; ++j) nonzero += line[j] != 0;
+    }
+    return nonzero * 5 < (size_t)rows_ * columns_ * 2;
   }
 
   /* operators overloads */
@@ -107,18 +449,79 @@ class S21Matrix {
     }
     Clear();
     DistributionMemory(other.rows_, other.columns_);
-    for (int i = 0; i < rows_; i++) {
-      for (int j = 0; j < columns_; j++) {
-        matrix_[i][j] = other.matrix_[i][j];
-      }
+    std::memcpy(matrix_, other.matrix_,
+                (size_t)rows_ * stride_ * sizeof(T));
+    return *this;
+  }
+
+  /* the expression is evaluated row by row straight into this matrix; if
+   * it reads the matrix at other positions than the one being written, it
+   * goes through a temporary first */
+  template <class E>
+  S21Matrix& operator=(const S21MatrixExpr<E>& expr) {
+    const E& e = expr.self();
+    bool resized = e.get_rows() != rows_ || e.get_columns() != columns_;
+    if ((!E::kInPlaceSafe || resized) && e.Reads(matrix_)) {
+      S21Matrix result(e);
+      Swap(result);
+      return *this;
+    }
+    Resize(e.get_rows(), e.get_columns());
+    for (int i = 0; i < rows_; ++i) e.EvalRow(i, row(i));
+    return *this;
+  }
+
+  /* a product on its own goes through the blocked gemm */
+  S21Matrix& operator=(const S21ExprProduct<T>& product) {
+    if (product.get_rows() == 1) {
+      return *this = static_cast<const S21MatrixExpr<S21ExprProduct<T>>&>(
+                 product);
     }
+    Gemm(product.get_a(), product.get_b(), false, product.get_transpose_b());
     return *this;
   }
 
-  S21Matrix operator*(const S21Matrix& other) {
-    S21Matrix newMatrix(*this);
-    newMatrix.MulMatrix(other);
-    return newMatrix;
+  /* a product on its own is accumulated by the blocked gemm straight into
+   * the matrix */
+  S21Matrix& operator+=(const S21ExprProduct<T>& product) {
+    AccumulateProduct<1>(product);
+    return *this;
+  }
+  S21Matrix& operator-=(const S21ExprProduct<T>& product) {
+    AccumulateProduct<-1>(product);
+    return *this;
+  }
+
+  template <class E>
+  S21Matrix& operator+=(const S21MatrixExpr<E>& expr) {
+    AccumulateExpr<1>(expr.self());
+    return *this;
+  }
+
+  template <class E>
+  S21Matrix& operator-=(const S21MatrixExpr<E>& expr) {
+    AccumulateExpr<-1>(expr.self());
+    return *this;
+  }
+
+  /* rank-1 updates run on the Ger kernel */
+  S21Matrix& operator+=(const S21ExprOuter<T>& update) {
+    return *this += T(1) * update;
+  }
+  S21Matrix& operator-=(const S21ExprOuter<T>& update) {
+    return *this += T(-1) * update;
+  }
+  S21Matrix& operator+=(const S21ExprScale<S21ExprOuter<T>>& update) {
+    if (update.Reads(matrix_)) {
+      AccumulateExpr<1>(update);
+    } else {
+      const S21ExprOuter<T>& outer = update.get_expr();
+      AddOuterProduct(outer.get_x(), outer.get_y(), update.get_scale());
+    }
+    return *this;
+  }
+  S21Matrix& operator-=(const S21ExprScale<S21ExprOuter<T>>& update) {
+    return *this += -update.get_scale() * update.get_expr();
   }
 
   S21Matrix& operator*=(const S21Matrix& other) {
@@ -126,18 +529,18 @@ class S21Matrix {
     return *this;
   }
 
-  double& operator()(const int& row, const int& column) {
+  T& operator()(const int& row, const int& column) {
     if (rows_ <= row || columns_ <= column) {
       throw std::out_of_range("ERROR index out of range");
     }
-    return matrix_[row][column];
+    return matrix_[(size_t)row * stride_ + column];
   }
 
-  double operator()(const int& row, const int& column) const {
+  T operator()(const int& row, const int& column) const {
     if (rows_ <= row || columns_ <= column) {
       throw std::out_of_range("ERROR index out of range");
     }
-    return matrix_[row][column];
+    return matrix_[(size_t)row * stride_ + column];
   }
 
   std::pair<int, int> SearchMaxElement() {
@@ -146,12 +549,13 @@ class S21Matrix {
     }
 
     std::pair<int, int> result{0, 0};
-    double max_element = matrix_[0][0];
+    T max_element = matrix_[0];
 
     for (int i = 0; i < rows_; ++i) {
+      const T* line = row(i);
       for (int j = 0; j < columns_; ++j) {
-        if (max_element < matrix_[i][j]) {
-          max_element = matrix_[i][j];
+        if (max_element < line[j]) {
+          max_element = line[j];
           result = {i, j};
         }
       }
@@ -0,0 +1,175 @@
+#include "threadPool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace s21_network {
+
+namespace {
+
+/*---пул и очередь, которые обслуживает текущий поток---*/
+thread_local const ThreadPool *current_pool = nullptr;
+thread_local size_t current_queue = 0;
+
+}  // namespace
+
+ThreadPool::ThreadPool(const unsigned &threads) {
+  size_t sum_threads = threads;
+  if (sum_threads == 0) {
+    sum_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  /*---один из потоков - вызывающий, ему своя очередь не нужна---*/
+  for (size_t i = 0; i + 1 < sum_threads; ++i) {
+    queues_.emplace_back(new Queue());
+  }
+  for (size_t i = 0; i < queues_.size(); ++i) {
+    workers_.emplace_back([this, i]() { WorkerLoop(i); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (auto &worker : workers_) worker.join();
+}
+
+size_t ThreadPool::get_threads() const { return workers_.size() + 1; }
+
+void ThreadPool::ParallelFor(
+    const size_t &begin, const size_t &end, const size_t &grain,
+    const std::function<void(const size_t &, const size_t &)> &body) {
+  if (begin >= end) {
+    return;
+  }
+  size_t step = std::max<size_t>(grain, 1);
+  size_t tasks = (end - begin + step - 1) / step;
+  /*---без рабочих потоков или с одной задачей считаем на месте---*/
+  if (workers_.empty() || tasks == 1) {
+    for (size_t first = begin; first < end; first += step) {
+      body(first, std::min(first + step, end));
+    }
+    return;
+  }
+
+  Group group{};
+  group.remaining = tasks;
+  group.errors.resize(tasks);
+  size_t own = CurrentQueue();
+  /*---счетчик растет раньше, чем задачи попадут в очереди, иначе взятая
+   * задача уменьшила бы его ниже нуля---*/
+  pending_ += tasks;
+  for (size_t t = 0; t < tasks; ++t) {
+    size_t first = begin + t * step;
+    size_t last = std::min(first + step, end);
+    Task task{};
+    task.group = &group;
+    task.index = t;
+    task.run = [&body, first, last]() { body(first, last); };
+    /*---задачи рабочего потока - в его очередь, остальные поровну по
+     * очередям---*/
+    Push(own != kNoQueue ? own : next_queue_++ % queues_.size(),
+         std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+  }
+  wake_.notify_all();
+
+  /*---пока задачи вызова не закончены, помогаем их считать; если взять
+   * нечего, остальные задачи уже считаются, ждем их---*/
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(group.mutex);
+      if (group.remaining == 0) {
+        break;
+      }
+    }
+    if (!RunOneTask(own)) {
+      std::unique_lock<std::mutex> lock(group.mutex);
+      group.done.wait(lock, [&group]() { return group.remaining == 0; });
+      break;
+    }
+  }
+  for (auto &error : group.errors) {
+    if (error) std::rethrow_exception(error);
+  }
+}
+
+void ThreadPool::ParallelFor(
+    const size_t &tasks, const std::function<void(const size_t &)> &task) {
+  ParallelFor(0, tasks, 1,
+              [&task](const size_t &first, const size_t &) { task(first); });
+}
+
+void ThreadPool::WorkerLoop(const size_t &index) {
+  current_pool = this;
+  current_queue = index;
+  while (true) {
+    if (RunOneTask(index)) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    wake_.wait(lock, [this]() { return stop_ || pending_ > 0; });
+    if (stop_ && pending_ == 0) {
+      return;
+    }
+  }
+}
+
+bool ThreadPool::RunOneTask(const size_t &index) {
+  Task task{};
+  bool found = false;
+  if (index != kNoQueue) {
+    Queue &queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      found = true;
+    }
+  }
+  /*---своих задач нет - крадем самую старую задачу соседа---*/
+  size_t start = index != kNoQueue ? index + 1 : 0;
+  for (size_t i = 0; !found && i < queues_.size(); ++i) {
+    Queue &queue = *queues_[(start + i) % queues_.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      found = true;
+    }
+  }
+  if (!found) {
+    return false;
+  }
+  --pending_;
+
+  Group *group = task.group;
+  try {
+    task.run();
+  } catch (...) {
+    group->errors[task.index] = std::current_exception();
+  }
+  /*---после unlock вызывающий может удалить group, поэтому последняя
+   * задача будит его под замком---*/
+  std::lock_guard<std::mutex> lock(group->mutex);
+  if (--group->remaining == 0) {
+    group->done.notify_all();
+  }
+  return true;
+}
+
+void ThreadPool::Push(const size_t &index, Task task) {
+  Queue &queue = *queues_[index];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  queue.tasks.push_back(std::move(task));
+}
+
+size_t ThreadPool::CurrentQueue() const {
+  return current_pool == this ? current_queue : kNoQueue;
+}
+
+}  // namespace s21_network
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace s21_network {
+
+/*---пул потоков с кражей задач: у каждого рабочего потока своя очередь,
+ * свои задачи он берет с конца, а закончив их, забирает чужие с начала
+ * очередей других потоков. Поток, вызвавший ParallelFor, сам тоже считает
+ * задачи, пока не закончатся все задачи его вызова, поэтому ParallelFor
+ * можно вызывать и из задачи пула---*/
+class ThreadPool {
+ public:
+  /*---threads - все потоки вместе с вызывающим, 0 - по числу ядер---*/
+  explicit ThreadPool(const unsigned &threads = 0);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  size_t get_threads() const;
+
+  /*---[begin, end) делится на диапазоны по grain подряд (последний может
+   * быть короче), body(first, last) для каждого - отдельная задача: так
+   * сеть делит примеры пакета, а gemm - панели строк или столбцов
+   * произведений слоя. Возврат после всех задач; ошибка задачи
+   * передается дальше, первой - ошибка диапазона с меньшим началом---*/
+  void ParallelFor(
+      const size_t &begin, const size_t &end, const size_t &grain,
+      const std::function<void(const size_t &, const size_t &)> &body);
+  /*---task(0) .. task(tasks - 1), по задаче на номер---*/
+  void ParallelFor(const size_t &tasks,
+                   const std::function<void(const size_t &)> &task);
+
+ private:
+  /*---задачи одного вызова ParallelFor---*/
+  struct Group {
+    size_t remaining = 0;
+    std::mutex mutex{};
+    std::condition_variable done{};
+    std::vector<std::exception_ptr> errors{};
+  };
+  struct Task {
+    Group *group = nullptr;
+    size_t index = 0;
+    std::function<void()> run{};
+  };
+  struct Queue {
+    std::mutex mutex{};
+    std::deque<Task> tasks{};
+  };
+
+  void WorkerLoop(const size_t &index);
+  /*---берет задачу из своей очереди или крадет чужую и считает ее; false,
+   * если задач нет. index - очередь потока, kNoQueue у внешнего потока---*/
+  bool RunOneTask(const size_t &index);
+  void Push(const size_t &index, Task task);
+  /*---номер очереди текущего потока в этом пуле или kNoQueue---*/
+  size_t CurrentQueue() const;
+
+  static constexpr size_t kNoQueue = static_cast<size_t>(-1);
+
+  std::vector<std::unique_ptr<Queue>> queues_{};
+  std::vector<std::thread> workers_{};
+  std::atomic<size_t> pending_{0};  // задачи в очередях, еще не взятые
+  std::atomic<size_t> next_queue_{0};  // очередь для внешних потоков
+  std::mutex sleep_mutex_{};
+  std::condition_variable wake_{};
+  bool stop_ = false;
+};
+
+}  // namespace s21_network
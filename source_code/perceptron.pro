@@ -2,7 +2,14 @@ QT       += core gui
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
-CONFIG += c++11
+CONFIG += c++17
+
+# qmake CONFIG+=s21_cblas adds a compute backend over the system CBLAS,
+# point LIBS at another implementation (e.g. -lopenblas) if needed
+s21_cblas {
+    DEFINES += S21_WITH_CBLAS
+    LIBS += -lblas
+}
 
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
@@ -11,21 +18,35 @@ CONFIG += c++11
 SOURCES += \
     controller/controller.cpp \
     main.cpp \
+    model/computeBackend.cpp \
+    model/fixedNetwork.cpp \
     model/graphNetwork.cpp \
+    model/interfaceNetwork.cpp \
+    model/matrixKernels.cpp \
     model/matrixNetwork.cpp \
     model/network.cpp \
     model/neuron.cpp \
+    model/optimizer.cpp \
+    model/threadPool.cpp \
     view/learninggraph.cpp \
     view/mainwindow.cpp
 
 HEADERS += \
     controller/controller.hpp \
+    model/computeBackend.hpp \
+    model/fixedNetwork.hpp \
+    model/fixedNetworkLayers.inc \
     model/graphNetwork.hpp \
     model/interfaceNetwork.hpp \
+    model/matrixKernels.hpp \
+    model/matrixKernelsSimd.inc \
     model/matrixNetwork.hpp \
     model/network.hpp \
     model/neuron.h \
+    model/optimizer.hpp \
+    model/s21_matrix_expr.h \
     model/s21_matrix_oop.h \
+    model/threadPool.hpp \
     view/learninggraph.h \
     view/mainwindow.h \
     view/paintscene.h
@@ -123,7 +123,7 @@ void MainWindow::ButStartTestClick() {
   } else {
     double sample_percent = ui->sample_precent->value();
     auto start = std::chrono::high_resolution_clock::now();
-    S21Matrix conf_mx = controller_->StartConfusionTest(
+    S21Matrix<double> conf_mx = controller_->StartConfusionTest(
         name_test_file_.toStdString(), sample_percent);
     auto dur = std::chrono::high_resolution_clock::now() - start;
     auto mseconds =
@@ -265,6 +265,11 @@ void MainWindow::SlotLearningNetwork(const int &button) {
     graph_values = controller_->StartLearnNetwork(
         name_train_file_.toStdString(), sum_epoch, continue_learn,
         name_test_file_.toStdString());
+    LearnSpeed speed = controller_->get_learn_speed();
+    ui->label_time_value->setText(
+        QString::number(speed.seconds) + " s, " +
+        QString::number(speed.threads) + " threads, " +
+        QString::number(speed.samples_per_second, 'f', 0) + " samples/s");
   }
   if (graph_values.size() > 1) {
     learning_graph_.set_values(graph_values);